@@ -0,0 +1,110 @@
+/**
+ * @file BloqueHistorial.h
+ * @brief Bloque sellado y comprimido de lecturas para el historial de un sensor
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef BLOQUE_HISTORIAL_H
+#define BLOQUE_HISTORIAL_H
+
+#include "CodecHistorial.h"
+
+/**
+ * @brief Bloque de lecturas codificadas con CodecHistorial<T>
+ *
+ * Guarda junto a los bytes codificados el mínimo, el máximo y la suma del
+ * bloque, de modo que los agregados y la búsqueda pueden descartar bloques
+ * completos sin decodificarlos.
+ *
+ * @tparam T Tipo de dato de las lecturas
+ */
+template <typename T>
+struct BloqueHistorial {
+    unsigned char* datos;          ///< Lecturas codificadas
+    int bytes;                     ///< Tamaño de datos en bytes
+    int cantidad;                  ///< Número de lecturas del bloque
+    T minimo;                      ///< Menor lectura del bloque
+    T maximo;                      ///< Mayor lectura del bloque
+    double suma;                   ///< Suma de las lecturas del bloque
+    BloqueHistorial<T>* siguiente; ///< Siguiente bloque (más reciente)
+
+    /**
+     * @brief Construye un bloque codificando las lecturas dadas
+     * @param valores Lecturas en orden de llegada
+     * @param n Número de lecturas (mayor que 0)
+     */
+    BloqueHistorial(const T* valores, int n) : datos(nullptr), bytes(0), cantidad(0),
+                                               minimo(T{}), maximo(T{}), suma(0.0), siguiente(nullptr) {
+        recodificar(valores, n);
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~BloqueHistorial() {
+        delete[] datos;
+    }
+
+    /**
+     * @brief Reemplaza el contenido del bloque
+     * @param valores Lecturas en orden de llegada
+     * @param n Número de lecturas (mayor que 0)
+     */
+    void recodificar(const T* valores, int n) {
+        EscritorBits escritor(n * static_cast<int>(sizeof(T)) / 2 + 16);
+        CodecHistorial<T>::codificar(valores, n, escritor);
+        delete[] datos;
+        datos = escritor.finalizar(bytes);
+        cantidad = n;
+
+        minimo = valores[0];
+        maximo = valores[0];
+        suma = 0.0;
+        for (int i = 0; i < n; i++) {
+            if (valores[i] < minimo) {
+                minimo = valores[i];
+            }
+            if (valores[i] > maximo) {
+                maximo = valores[i];
+            }
+            suma += static_cast<double>(valores[i]);
+        }
+    }
+
+    /**
+     * @brief Decodifica las lecturas del bloque
+     * @param valores Arreglo con al menos cantidad posiciones
+     */
+    void decodificar(T* valores) const {
+        CodecHistorial<T>::decodificar(datos, cantidad, valores);
+    }
+
+    /**
+     * @brief Crea una copia del bloque sin volver a codificar
+     * @return Bloque nuevo con los mismos bytes y siguiente = nullptr
+     */
+    BloqueHistorial<T>* clonar() const {
+        BloqueHistorial<T>* copia = new BloqueHistorial<T>();
+        copia->datos = new unsigned char[bytes > 0 ? bytes : 1];
+        std::memcpy(copia->datos, datos, bytes);
+        copia->bytes = bytes;
+        copia->cantidad = cantidad;
+        copia->minimo = minimo;
+        copia->maximo = maximo;
+        copia->suma = suma;
+        return copia;
+    }
+
+private:
+    /**
+     * @brief Constructor de un bloque vacío (solo para clonar())
+     */
+    BloqueHistorial() : datos(nullptr), bytes(0), cantidad(0),
+                        minimo(T{}), maximo(T{}), suma(0.0), siguiente(nullptr) {}
+
+    BloqueHistorial(const BloqueHistorial&);             ///< No copiable
+    BloqueHistorial& operator=(const BloqueHistorial&);  ///< No asignable
+};
+
+#endif // BLOQUE_HISTORIAL_H
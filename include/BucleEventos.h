@@ -0,0 +1,231 @@
+/**
+ * @file BucleEventos.h
+ * @brief Bucle de eventos de un solo hilo basado en corrutinas y epoll
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef BUCLE_EVENTOS_H
+#define BUCLE_EVENTOS_H
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+
+/**
+ * @brief Corrutina lanzada en el bucle de eventos
+ *
+ * Empieza a ejecutarse en cuanto se llama y libera su marco al terminar; el
+ * llamador no conserva ningún manejador. Mientras está suspendida, el bucle
+ * es quien la reanuda (o destruye su marco si se detiene antes).
+ */
+struct TareaEventos {
+    struct promise_type {
+        TareaEventos get_return_object() noexcept { return TareaEventos(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+/**
+ * @brief Multiplexor de descriptores y temporizadores para corrutinas
+ *
+ * Todas las tareas corren en el hilo que llama a ejecutar(): una tarea se
+ * suspende con `co_await` hasta que su descriptor tenga datos o venza su
+ * plazo, y mientras tanto el bucle atiende a las demás. Los descriptores que
+ * epoll no admite (archivos regulares) se consideran siempre listos y su
+ * tarea cede el turno en cada espera, de modo que tampoco acaparan el bucle.
+ *
+ * Cada descriptor admite una sola tarea en espera a la vez.
+ *
+ * Con detenerConSenales(), SIGINT y SIGTERM se reciben por un descriptor
+ * propio del bucle y hacen que ejecutar() vuelva como con detener().
+ */
+class BucleEventos {
+public:
+    /**
+     * @brief Espera a que un descriptor tenga datos para leer
+     */
+    struct EsperaLectura {
+        BucleEventos* bucle;  ///< Bucle que reanudará la tarea
+        int fd;               ///< Descriptor observado
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> tarea) { bucle->registrarLectura(fd, tarea); }
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Espera a que transcurra un plazo
+     */
+    struct EsperaTiempo {
+        BucleEventos* bucle;  ///< Bucle que reanudará la tarea
+        double segundos;      ///< Plazo desde la suspensión
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> tarea) { bucle->registrarTemporizador(segundos, tarea); }
+        void await_resume() const noexcept {}
+    };
+
+private:
+    /**
+     * @brief Tarea suspendida a la espera de un descriptor
+     */
+    struct EsperaDescriptor {
+        int fd;                          ///< Descriptor observado
+        std::coroutine_handle<> tarea;   ///< Tarea a reanudar
+    };
+
+    /**
+     * @brief Tarea suspendida hasta un instante
+     */
+    struct Temporizador {
+        double vence;                    ///< Instante monotónico (s) de reanudación
+        std::coroutine_handle<> tarea;   ///< Tarea a reanudar
+    };
+
+    int epoll;                           ///< Descriptor de epoll (-1 si no se pudo crear)
+    int senales;                         ///< signalfd de SIGINT/SIGTERM (-1 si no se atienden)
+    int senalRecibida;                   ///< Última señal que detuvo el bucle (0 si ninguna)
+    bool detenido;                       ///< Si ejecutar() debe volver
+    EsperaDescriptor* esperas;           ///< Tareas esperando descriptores
+    int numEsperas;
+    int capacidadEsperas;
+    Temporizador* temporizadores;        ///< Tareas esperando un plazo
+    int numTemporizadores;
+    int capacidadTemporizadores;
+    std::coroutine_handle<>* listas;     ///< Tareas listas para reanudarse
+    int numListas;
+    int capacidadListas;
+
+public:
+    /**
+     * @brief Constructor - crea la instancia de epoll
+     */
+    BucleEventos();
+
+    /**
+     * @brief Destructor - destruye los marcos de las tareas aún suspendidas
+     */
+    ~BucleEventos();
+
+    /**
+     * @brief Indica si el bucle puede usarse
+     * @return false si el sistema no ofrece epoll
+     */
+    bool estaDisponible() const;
+
+    /**
+     * @brief Suspende la tarea hasta que fd tenga datos (o se cierre)
+     * @param fd Descriptor de lectura
+     * @return Objeto para `co_await`
+     */
+    EsperaLectura esperarLectura(int fd) { return EsperaLectura{this, fd}; }
+
+    /**
+     * @brief Suspende la tarea durante el plazo indicado
+     * @param segundos Plazo en segundos
+     * @return Objeto para `co_await`
+     */
+    EsperaTiempo dormir(double segundos) { return EsperaTiempo{this, segundos}; }
+
+    /**
+     * @brief Atiende las tareas hasta que se llame a detener() o no quede ninguna
+     */
+    void ejecutar();
+
+    /**
+     * @brief Hace que ejecutar() vuelva tras el evento en curso
+     */
+    void detener();
+
+    /**
+     * @brief Detiene el bucle al recibir SIGINT o SIGTERM en lugar de terminar el proceso
+     *
+     * Las señales quedan bloqueadas en el hilo que llama mientras exista el
+     * bucle. El descriptor de señales no cuenta como tarea pendiente.
+     *
+     * @return false si no se pudo crear el descriptor de señales
+     */
+    bool detenerConSenales();
+
+    /**
+     * @brief Obtiene la señal que detuvo el bucle
+     * @return Número de señal, o 0 si el bucle no se detuvo por una señal
+     */
+    int obtenerSenalRecibida() const;
+
+private:
+    /**
+     * @brief Anota una tarea a la espera de un descriptor
+     * @param fd Descriptor observado
+     * @param tarea Tarea suspendida
+     */
+    void registrarLectura(int fd, std::coroutine_handle<> tarea);
+
+    /**
+     * @brief Anota una tarea a la espera de un plazo
+     * @param segundos Plazo desde ahora
+     * @param tarea Tarea suspendida
+     */
+    void registrarTemporizador(double segundos, std::coroutine_handle<> tarea);
+
+    /**
+     * @brief Encola una tarea para reanudarla en la próxima vuelta
+     * @param tarea Tarea suspendida
+     */
+    void encolar(std::coroutine_handle<> tarea);
+
+    /**
+     * @brief Reanuda las tareas cuyo descriptor está listo o cuyo plazo venció
+     * @param espera Milisegundos máximos de espera (-1 = sin límite)
+     */
+    void atenderEventos(int espera);
+
+    BucleEventos(const BucleEventos&);             ///< No copiable
+    BucleEventos& operator=(const BucleEventos&);  ///< No asignable
+};
+
+/**
+ * @brief Separa en líneas lo que llega por un descriptor no bloqueante
+ *
+ * Las líneas más largas que el búfer se descartan completas.
+ */
+class LectorLineas {
+public:
+    static const std::size_t TAM_BUFER = 4096;  ///< Longitud máxima de línea (con el salto)
+
+private:
+    int fd;                      ///< Descriptor de origen
+    char bufer[TAM_BUFER + 1];   ///< Datos recibidos aún no entregados
+    std::size_t inicio;          ///< Primer byte pendiente
+    std::size_t fin;             ///< Fin de los datos recibidos
+    bool descartando;            ///< Si se está saltando una línea demasiado larga
+    bool cerrado;                ///< Si el origen llegó al fin de archivo
+
+public:
+    /**
+     * @brief Constructor
+     * @param fd Descriptor de origen (no se cierra al destruir)
+     */
+    explicit LectorLineas(int fd);
+
+    /**
+     * @brief Lee lo disponible en el descriptor sin bloquear
+     * @return false si el origen se cerró (o falló) y no llegarán más datos
+     */
+    bool llenar();
+
+    /**
+     * @brief Entrega la siguiente línea completa, sin el salto de línea
+     *
+     * Tras el cierre del origen también entrega la última línea aunque le
+     * falte el salto.
+     *
+     * @param largo Recibe la longitud de la línea
+     * @return Línea terminada en nulo (válida hasta la próxima llamada), o nullptr
+     */
+    char* siguienteLinea(std::size_t& largo);
+};
+
+#endif // BUCLE_EVENTOS_H
@@ -0,0 +1,405 @@
+/**
+ * @file CodecHistorial.h
+ * @brief Codificación compacta de bloques de lecturas (Gorilla XOR y delta de deltas)
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef CODEC_HISTORIAL_H
+#define CODEC_HISTORIAL_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Escritor de bits sobre un búfer de bytes que crece bajo demanda
+ */
+class EscritorBits {
+private:
+    unsigned char *datos;  ///< Búfer de salida
+    int capacidad;         ///< Bytes reservados
+    int bytes;             ///< Bytes completos escritos
+    uint64_t acumulador;   ///< Bits pendientes (alineados a la izquierda)
+    int bitsPendientes;    ///< Número de bits en el acumulador
+
+public:
+    /**
+     * @brief Constructor
+     * @param capacidadInicial Bytes a reservar de inicio
+     */
+    explicit EscritorBits(int capacidadInicial = 256)
+        : datos(new unsigned char[capacidadInicial]), capacidad(capacidadInicial),
+          bytes(0), acumulador(0), bitsPendientes(0) {}
+
+    /**
+     * @brief Destructor
+     */
+    ~EscritorBits()
+    {
+        delete[] datos;
+    }
+
+    /**
+     * @brief Escribe los bits menos significativos de un valor
+     * @param valor Valor cuyos bits se escriben (del más al menos significativo)
+     * @param numBits Número de bits a escribir (0..64)
+     */
+    void escribir(uint64_t valor, int numBits)
+    {
+        while (numBits > 0)
+        {
+            int libres = 64 - bitsPendientes;
+            int tomar = numBits < libres ? numBits : libres;
+            uint64_t parte = (tomar == 64) ? valor : ((valor >> (numBits - tomar)) & ((uint64_t(1) << tomar) - 1));
+            acumulador |= (tomar == 64) ? parte : (parte << (libres - tomar));
+            bitsPendientes += tomar;
+            numBits -= tomar;
+            if (bitsPendientes == 64)
+            {
+                volcar(8);
+            }
+        }
+    }
+
+    /**
+     * @brief Completa el último byte y devuelve una copia exacta del búfer
+     * @param tamanoSalida Recibe el número de bytes copiados
+     * @return Arreglo nuevo (liberar con delete[])
+     */
+    unsigned char *finalizar(int &tamanoSalida)
+    {
+        volcar((bitsPendientes + 7) / 8);
+        unsigned char *salida = new unsigned char[bytes > 0 ? bytes : 1];
+        std::memcpy(salida, datos, bytes);
+        tamanoSalida = bytes;
+        return salida;
+    }
+
+private:
+    /**
+     * @brief Mueve bytes completos del acumulador al búfer
+     * @param numBytes Número de bytes a mover
+     */
+    void volcar(int numBytes)
+    {
+        if (bytes + numBytes > capacidad)
+        {
+            int nueva = capacidad * 2 + numBytes;
+            unsigned char *mayor = new unsigned char[nueva];
+            std::memcpy(mayor, datos, bytes);
+            delete[] datos;
+            datos = mayor;
+            capacidad = nueva;
+        }
+        for (int i = 0; i < numBytes; i++)
+        {
+            datos[bytes++] = static_cast<unsigned char>(acumulador >> (56 - 8 * i));
+        }
+        acumulador = 0;
+        bitsPendientes = 0;
+    }
+
+    EscritorBits(const EscritorBits &);            ///< No copiable
+    EscritorBits &operator=(const EscritorBits &); ///< No asignable
+};
+
+/**
+ * @brief Lector de bits sobre un búfer producido por EscritorBits
+ */
+class LectorBits {
+private:
+    const unsigned char *datos;  ///< Búfer de entrada
+    long posicion;               ///< Posición actual en bits
+
+public:
+    /**
+     * @brief Constructor
+     * @param entrada Búfer a leer
+     */
+    explicit LectorBits(const unsigned char *entrada) : datos(entrada), posicion(0) {}
+
+    /**
+     * @brief Lee un número de bits como entero sin signo
+     * @param numBits Número de bits a leer (0..64)
+     * @return Valor leído
+     */
+    uint64_t leer(int numBits)
+    {
+        uint64_t valor = 0;
+        while (numBits > 0)
+        {
+            int desplazamiento = static_cast<int>(posicion & 7);
+            int disponibles = 8 - desplazamiento;
+            int tomar = numBits < disponibles ? numBits : disponibles;
+            unsigned int byte = datos[posicion >> 3];
+            unsigned int parte = (byte >> (disponibles - tomar)) & ((1u << tomar) - 1);
+            valor = (valor << tomar) | parte;
+            posicion += tomar;
+            numBits -= tomar;
+        }
+        return valor;
+    }
+
+    /**
+     * @brief Lee un único bit
+     * @return true si el bit vale 1
+     */
+    bool leerBit()
+    {
+        return leer(1) != 0;
+    }
+};
+
+/**
+ * @brief Codificador de bloques de lecturas según el tipo de dato
+ *
+ * - Punto flotante: esquema XOR de Gorilla. Cada valor se combina por XOR con
+ *   el anterior; un 0 cuesta un bit y, si no, solo se guardan los bits
+ *   significativos, reutilizando la ventana previa cuando cabe.
+ * - Enteros: delta de deltas con prefijos de longitud variable. Una serie con
+ *   pendiente constante cuesta un bit por lectura.
+ *
+ * @tparam T Tipo de dato de las lecturas
+ */
+template <typename T>
+class CodecHistorial {
+public:
+    /**
+     * @brief Codifica un arreglo de lecturas
+     * @param valores Lecturas a codificar
+     * @param n Número de lecturas (mayor que 0)
+     * @param salida Escritor que recibe los bits
+     */
+    static void codificar(const T *valores, int n, EscritorBits &salida)
+    {
+        if constexpr (std::is_floating_point<T>::value)
+        {
+            codificarXor(valores, n, salida);
+        }
+        else
+        {
+            codificarDeltas(valores, n, salida);
+        }
+    }
+
+    /**
+     * @brief Decodifica un bloque de lecturas
+     * @param datos Búfer codificado
+     * @param n Número de lecturas del bloque
+     * @param valores Arreglo que recibe las lecturas (al menos n posiciones)
+     */
+    static void decodificar(const unsigned char *datos, int n, T *valores)
+    {
+        if constexpr (std::is_floating_point<T>::value)
+        {
+            decodificarXor(datos, n, valores);
+        }
+        else
+        {
+            decodificarDeltas(datos, n, valores);
+        }
+    }
+
+private:
+    /// Entero sin signo del mismo ancho que T (para los flotantes)
+    typedef typename std::conditional<sizeof(T) == 8, uint64_t, uint32_t>::type Bits;
+
+    static const int ANCHO = static_cast<int>(sizeof(T) * 8);       ///< Bits de un valor
+    static const int BITS_CEROS = ANCHO == 64 ? 6 : 5;              ///< Bits del conteo de ceros iniciales
+
+    /**
+     * @brief Cuenta ceros a la izquierda en un valor de ANCHO bits
+     */
+    static int cerosIniciales(Bits x)
+    {
+        int n = 0;
+        for (Bits mascara = Bits(1) << (ANCHO - 1); mascara != 0 && (x & mascara) == 0; mascara >>= 1)
+        {
+            n++;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Cuenta ceros a la derecha en un valor distinto de cero
+     */
+    static int cerosFinales(Bits x)
+    {
+        int n = 0;
+        while ((x & 1) == 0)
+        {
+            x >>= 1;
+            n++;
+        }
+        return n;
+    }
+
+    static void codificarXor(const T *valores, int n, EscritorBits &salida)
+    {
+        Bits anterior;
+        std::memcpy(&anterior, &valores[0], sizeof(T));
+        salida.escribir(anterior, ANCHO);
+
+        int cerosPrevios = ANCHO + 1; // Ventana previa inválida
+        int finalesPrevios = 0;
+
+        for (int i = 1; i < n; i++)
+        {
+            Bits actual;
+            std::memcpy(&actual, &valores[i], sizeof(T));
+            Bits x = actual ^ anterior;
+            anterior = actual;
+
+            if (x == 0)
+            {
+                salida.escribir(0, 1);
+                continue;
+            }
+            salida.escribir(1, 1);
+
+            int ceros = cerosIniciales(x);
+            int finales = cerosFinales(x);
+            int maxCeros = (1 << BITS_CEROS) - 1;
+            if (ceros > maxCeros)
+            {
+                ceros = maxCeros;
+            }
+
+            if (ceros >= cerosPrevios && finales >= finalesPrevios)
+            {
+                // Cabe en la ventana anterior
+                salida.escribir(0, 1);
+                salida.escribir(x >> finalesPrevios, ANCHO - cerosPrevios - finalesPrevios);
+            }
+            else
+            {
+                int significativos = ANCHO - ceros - finales;
+                salida.escribir(1, 1);
+                salida.escribir(ceros, BITS_CEROS);
+                salida.escribir(significativos - 1, ANCHO == 64 ? 6 : 5);
+                salida.escribir(x >> finales, significativos);
+                cerosPrevios = ceros;
+                finalesPrevios = finales;
+            }
+        }
+    }
+
+    static void decodificarXor(const unsigned char *datos, int n, T *valores)
+    {
+        LectorBits entrada(datos);
+        Bits anterior = static_cast<Bits>(entrada.leer(ANCHO));
+        std::memcpy(&valores[0], &anterior, sizeof(T));
+
+        int cerosPrevios = 0;
+        int finalesPrevios = 0;
+
+        for (int i = 1; i < n; i++)
+        {
+            if (entrada.leerBit())
+            {
+                if (entrada.leerBit())
+                {
+                    cerosPrevios = static_cast<int>(entrada.leer(BITS_CEROS));
+                    int significativos = static_cast<int>(entrada.leer(ANCHO == 64 ? 6 : 5)) + 1;
+                    finalesPrevios = ANCHO - cerosPrevios - significativos;
+                }
+                int significativos = ANCHO - cerosPrevios - finalesPrevios;
+                Bits x = static_cast<Bits>(entrada.leer(significativos)) << finalesPrevios;
+                anterior ^= x;
+            }
+            std::memcpy(&valores[i], &anterior, sizeof(T));
+        }
+    }
+
+    /**
+     * @brief Codificación zigzag: intercala negativos y positivos
+     */
+    static uint64_t zigzag(int64_t v)
+    {
+        return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    }
+
+    /**
+     * @brief Inversa de zigzag()
+     */
+    static int64_t desZigzag(uint64_t v)
+    {
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    static void codificarDeltas(const T *valores, int n, EscritorBits &salida)
+    {
+        salida.escribir(zigzag(static_cast<int64_t>(valores[0])), 64);
+        int64_t deltaPrevio = 0;
+
+        for (int i = 1; i < n; i++)
+        {
+            int64_t delta = static_cast<int64_t>(valores[i]) - static_cast<int64_t>(valores[i - 1]);
+            uint64_t dd = zigzag(delta - deltaPrevio);
+            deltaPrevio = delta;
+
+            if (dd == 0)
+            {
+                salida.escribir(0, 1);        // '0'
+            }
+            else if (dd < (1u << 7))
+            {
+                salida.escribir(2, 2);        // '10' + 7 bits
+                salida.escribir(dd, 7);
+            }
+            else if (dd < (1u << 9))
+            {
+                salida.escribir(6, 3);        // '110' + 9 bits
+                salida.escribir(dd, 9);
+            }
+            else if (dd < (1u << 12))
+            {
+                salida.escribir(14, 4);       // '1110' + 12 bits
+                salida.escribir(dd, 12);
+            }
+            else
+            {
+                salida.escribir(15, 4);       // '1111' + 64 bits
+                salida.escribir(dd, 64);
+            }
+        }
+    }
+
+    static void decodificarDeltas(const unsigned char *datos, int n, T *valores)
+    {
+        LectorBits entrada(datos);
+        int64_t actual = desZigzag(entrada.leer(64));
+        valores[0] = static_cast<T>(actual);
+        int64_t delta = 0;
+
+        for (int i = 1; i < n; i++)
+        {
+            uint64_t dd = 0;
+            if (entrada.leerBit())
+            {
+                if (!entrada.leerBit())
+                {
+                    dd = entrada.leer(7);
+                }
+                else if (!entrada.leerBit())
+                {
+                    dd = entrada.leer(9);
+                }
+                else if (!entrada.leerBit())
+                {
+                    dd = entrada.leer(12);
+                }
+                else
+                {
+                    dd = entrada.leer(64);
+                }
+            }
+            delta += desZigzag(dd);
+            actual += delta;
+            valores[i] = static_cast<T>(actual);
+        }
+    }
+};
+
+#endif // CODEC_HISTORIAL_H
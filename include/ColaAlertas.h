@@ -0,0 +1,77 @@
+/**
+ * @file ColaAlertas.h
+ * @brief Cola sin bloqueos (un productor, un consumidor) de alertas de reglas
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef COLA_ALERTAS_H
+#define COLA_ALERTAS_H
+
+#include "SensorBase.h"
+#include <atomic>
+
+/**
+ * @brief Alerta emitida por el motor de reglas
+ */
+struct Alerta {
+    int regla;                          ///< Identificador de la regla disparada
+    unsigned int manejador;             ///< Manejador del sensor que la disparó
+    char sensor[TAM_NOMBRE_SENSOR];     ///< Nombre del sensor
+    double valor;                       ///< Valor evaluado (lectura, variación o promedio)
+    double marcaTiempo;                 ///< Marca de tiempo (s) de la lectura
+};
+
+/**
+ * @brief Anillo de alertas de un productor y un consumidor
+ *
+ * El hilo de ingesta publica y el hilo que atiende las alertas extrae; ninguno
+ * de los dos se bloquea. Si el anillo está lleno la alerta se descarta y se
+ * contabiliza, de forma que la ingesta nunca espera al consumidor.
+ */
+class ColaAlertas {
+private:
+    Alerta* anillo;                                  ///< Ranuras del anillo
+    unsigned int mascara;                            ///< Capacidad - 1 (capacidad potencia de 2)
+    alignas(64) std::atomic<unsigned int> cola;      ///< Siguiente ranura a escribir (productor)
+    alignas(64) std::atomic<unsigned int> cabeza;    ///< Siguiente ranura a leer (consumidor)
+    alignas(64) std::atomic<long long> descartadas;  ///< Alertas perdidas por anillo lleno
+
+public:
+    /**
+     * @brief Constructor
+     * @param capacidad Ranuras del anillo (se redondea a potencia de 2)
+     */
+    ColaAlertas(unsigned int capacidad = 1024);
+
+    /**
+     * @brief Destructor
+     */
+    ~ColaAlertas();
+
+    /**
+     * @brief Publica una alerta (solo desde el hilo productor)
+     * @param alerta Alerta a publicar
+     * @return true si se encoló, false si el anillo estaba lleno
+     */
+    bool publicar(const Alerta& alerta);
+
+    /**
+     * @brief Extrae la alerta más antigua (solo desde el hilo consumidor)
+     * @param alerta Recibe la alerta extraída
+     * @return true si había una alerta pendiente
+     */
+    bool extraer(Alerta& alerta);
+
+    /**
+     * @brief Obtiene el número de alertas descartadas por anillo lleno
+     * @return Alertas descartadas desde la creación
+     */
+    long long obtenerDescartadas() const;
+
+private:
+    ColaAlertas(const ColaAlertas&);             ///< No copiable
+    ColaAlertas& operator=(const ColaAlertas&);  ///< No asignable
+};
+
+#endif // COLA_ALERTAS_H
@@ -0,0 +1,427 @@
+/**
+ * @file EstadisticaFlujo.h
+ * @brief Estimadores en flujo (varianza de Welford y cuantiles t-digest) para lecturas
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef ESTADISTICA_FLUJO_H
+#define ESTADISTICA_FLUJO_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/**
+ * @brief Media y varianza en una sola pasada (algoritmo de Welford)
+ *
+ * Ocupa memoria constante y se puede fusionar con otro estimador mediante
+ * la fórmula de Chan, lo que permite combinar resultados de varios sensores.
+ */
+class EstimadorVarianza {
+private:
+    long long cantidad;  ///< Número de muestras
+    double media;        ///< Media acumulada
+    double m2;           ///< Suma de cuadrados de las desviaciones
+    double minimo;       ///< Menor muestra
+    double maximo;       ///< Mayor muestra
+
+public:
+    /**
+     * @brief Constructor por defecto
+     */
+    EstimadorVarianza() : cantidad(0), media(0.0), m2(0.0), minimo(0.0), maximo(0.0) {}
+
+    /**
+     * @brief Incorpora una muestra
+     * @param valor Muestra a incorporar
+     */
+    void agregar(double valor)
+    {
+        cantidad++;
+        double delta = valor - media;
+        media += delta / static_cast<double>(cantidad);
+        m2 += delta * (valor - media);
+
+        if (cantidad == 1 || valor < minimo)
+        {
+            minimo = valor;
+        }
+        if (cantidad == 1 || valor > maximo)
+        {
+            maximo = valor;
+        }
+    }
+
+    /**
+     * @brief Fusiona las muestras de otro estimador en este
+     * @param otro Estimador a fusionar
+     */
+    void fusionar(const EstimadorVarianza &otro)
+    {
+        if (otro.cantidad == 0)
+        {
+            return;
+        }
+        if (cantidad == 0)
+        {
+            *this = otro;
+            return;
+        }
+
+        double n1 = static_cast<double>(cantidad);
+        double n2 = static_cast<double>(otro.cantidad);
+        double delta = otro.media - media;
+        double total = n1 + n2;
+
+        media += delta * n2 / total;
+        m2 += otro.m2 + delta * delta * n1 * n2 / total;
+        cantidad += otro.cantidad;
+        minimo = std::min(minimo, otro.minimo);
+        maximo = std::max(maximo, otro.maximo);
+    }
+
+    long long obtenerCantidad() const { return cantidad; }  ///< Número de muestras
+    double obtenerMedia() const { return media; }           ///< Media de las muestras
+    double obtenerMinimo() const { return minimo; }         ///< Menor muestra
+    double obtenerMaximo() const { return maximo; }         ///< Mayor muestra
+
+    /**
+     * @brief Varianza muestral
+     * @return Varianza (0 con menos de dos muestras)
+     */
+    double obtenerVarianza() const
+    {
+        return cantidad > 1 ? m2 / static_cast<double>(cantidad - 1) : 0.0;
+    }
+
+    /**
+     * @brief Desviación estándar muestral
+     * @return Raíz cuadrada de la varianza
+     */
+    double obtenerDesviacion() const
+    {
+        return std::sqrt(obtenerVarianza());
+    }
+};
+
+/**
+ * @brief Estimador de cuantiles t-digest (variante de fusión)
+ *
+ * Las muestras se acumulan en un búfer; al llenarse se ordenan junto con los
+ * centroides existentes y se fusionan según la función de escala k1, que
+ * conserva centroides pequeños en las colas (p95, p99). La memoria está
+ * acotada por COMPRESION independientemente del número de muestras y solo
+ * se reserva al llegar la primera muestra.
+ */
+class DigestoCuantiles {
+public:
+    static const int COMPRESION = 50;                ///< Parámetro delta del t-digest
+    static const int MAX_CENTROIDES = COMPRESION + 10; ///< Cota de centroides tras fusionar
+    static const int TAM_BUFER = 64;                 ///< Muestras sin fusionar
+
+private:
+    /**
+     * @brief Centroide (o muestra pendiente, con peso 1)
+     */
+    struct Centroide {
+        double media;  ///< Media de las muestras del centroide
+        double peso;   ///< Número de muestras representadas
+    };
+
+    Centroide *centroides; ///< Centroides fusionados seguidos del búfer
+    int numCentroides;     ///< Centroides ya fusionados
+    int numPendientes;     ///< Muestras en el búfer
+
+public:
+    /**
+     * @brief Constructor por defecto (no reserva memoria)
+     */
+    DigestoCuantiles() : centroides(nullptr), numCentroides(0), numPendientes(0) {}
+
+    /**
+     * @brief Constructor de copia
+     * @param otro Digesto a copiar
+     */
+    DigestoCuantiles(const DigestoCuantiles &otro) : centroides(nullptr), numCentroides(0), numPendientes(0)
+    {
+        *this = otro;
+    }
+
+    /**
+     * @brief Operador de asignación
+     * @param otro Digesto a asignar
+     * @return Referencia a este digesto
+     */
+    DigestoCuantiles &operator=(const DigestoCuantiles &otro)
+    {
+        if (this != &otro)
+        {
+            if (otro.centroides == nullptr)
+            {
+                delete[] centroides;
+                centroides = nullptr;
+            }
+            else
+            {
+                reservar();
+                std::memcpy(centroides, otro.centroides,
+                            sizeof(Centroide) * (otro.numCentroides + otro.numPendientes));
+            }
+            numCentroides = otro.numCentroides;
+            numPendientes = otro.numPendientes;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~DigestoCuantiles()
+    {
+        delete[] centroides;
+    }
+
+    /**
+     * @brief Incorpora una muestra
+     * @param valor Muestra a incorporar
+     */
+    void agregar(double valor)
+    {
+        agregarPonderado(valor, 1.0);
+    }
+
+    /**
+     * @brief Fusiona los centroides de otro digesto en este
+     * @param otro Digesto a fusionar
+     */
+    void fusionar(const DigestoCuantiles &otro)
+    {
+        for (int i = 0; i < otro.numCentroides + otro.numPendientes; i++)
+        {
+            agregarPonderado(otro.centroides[i].media, otro.centroides[i].peso);
+        }
+    }
+
+    /**
+     * @brief Estima un cuantil
+     * @param q Cuantil deseado en [0, 1]
+     * @param minimo Menor muestra observada (extremo izquierdo)
+     * @param maximo Mayor muestra observada (extremo derecho)
+     * @return Valor estimado del cuantil (0 si no hay muestras)
+     */
+    double cuantil(double q, double minimo, double maximo) const
+    {
+        int total = numCentroides + numPendientes;
+        if (total == 0)
+        {
+            return 0.0;
+        }
+
+        // Trabajar sobre una copia local para no mutar el digesto
+        Centroide local[MAX_CENTROIDES + TAM_BUFER];
+        std::memcpy(local, centroides, sizeof(Centroide) * total);
+        int n = comprimir(local, total);
+
+        double pesoTotal = 0.0;
+        for (int i = 0; i < n; i++)
+        {
+            pesoTotal += local[i].peso;
+        }
+
+        q = std::min(1.0, std::max(0.0, q));
+        double objetivo = q * pesoTotal;
+
+        // Interpolar linealmente entre los centros de masa de centroides vecinos
+        double acumulado = 0.0;
+        double centroAnterior = 0.0;
+        double valorAnterior = minimo;
+        for (int i = 0; i < n; i++)
+        {
+            double centro = acumulado + local[i].peso / 2.0;
+            if (objetivo < centro)
+            {
+                if (centro == centroAnterior)
+                {
+                    return local[i].media;
+                }
+                double t = (objetivo - centroAnterior) / (centro - centroAnterior);
+                return valorAnterior + t * (local[i].media - valorAnterior);
+            }
+            acumulado += local[i].peso;
+            centroAnterior = centro;
+            valorAnterior = local[i].media;
+        }
+
+        if (pesoTotal == centroAnterior)
+        {
+            return maximo;
+        }
+        double t = (objetivo - centroAnterior) / (pesoTotal - centroAnterior);
+        return valorAnterior + t * (maximo - valorAnterior);
+    }
+
+private:
+    /**
+     * @brief Reserva el arreglo de centroides si aún no existe
+     */
+    void reservar()
+    {
+        if (centroides == nullptr)
+        {
+            centroides = new Centroide[MAX_CENTROIDES + TAM_BUFER];
+        }
+    }
+
+    /**
+     * @brief Agrega una muestra con peso al búfer, fusionando si está lleno
+     * @param valor Media de la muestra
+     * @param peso Peso de la muestra
+     */
+    void agregarPonderado(double valor, double peso)
+    {
+        reservar();
+        if (numPendientes == TAM_BUFER)
+        {
+            numCentroides = comprimir(centroides, numCentroides + numPendientes);
+            numPendientes = 0;
+        }
+        centroides[numCentroides + numPendientes].media = valor;
+        centroides[numCentroides + numPendientes].peso = peso;
+        numPendientes++;
+    }
+
+    /**
+     * @brief Ordena y fusiona centroides en el mismo arreglo
+     * @param datos Centroides a fusionar
+     * @param n Número de centroides de entrada
+     * @return Número de centroides resultantes
+     */
+    static int comprimir(Centroide *datos, int n)
+    {
+        std::sort(datos, datos + n, [](const Centroide &a, const Centroide &b)
+                  { return a.media < b.media; });
+
+        double pesoTotal = 0.0;
+        for (int i = 0; i < n; i++)
+        {
+            pesoTotal += datos[i].peso;
+        }
+
+        int salida = 0;
+        double pesoPrevio = 0.0;
+        double limite = pesoTotal * qDeK(kDeQ(0.0) + 1.0);
+
+        for (int i = 1; i < n; i++)
+        {
+            Centroide &actual = datos[salida];
+            if (pesoPrevio + actual.peso + datos[i].peso <= limite)
+            {
+                actual.media += (datos[i].media - actual.media) * datos[i].peso / (actual.peso + datos[i].peso);
+                actual.peso += datos[i].peso;
+            }
+            else
+            {
+                pesoPrevio += actual.peso;
+                limite = pesoTotal * qDeK(kDeQ(pesoPrevio / pesoTotal) + 1.0);
+                datos[++salida] = datos[i];
+            }
+        }
+        return n > 0 ? salida + 1 : 0;
+    }
+
+    /**
+     * @brief Función de escala k1: k(q) = delta / (2 pi) * asin(2q - 1)
+     * @param q Cuantil en [0, 1]
+     * @return Índice de escala
+     */
+    static double kDeQ(double q)
+    {
+        const double pi = 3.14159265358979323846;
+        return COMPRESION / (2.0 * pi) * std::asin(std::min(1.0, std::max(-1.0, 2.0 * q - 1.0)));
+    }
+
+    /**
+     * @brief Inversa de la función de escala k1
+     * @param k Índice de escala
+     * @return Cuantil correspondiente en [0, 1]
+     */
+    static double qDeK(double k)
+    {
+        const double pi = 3.14159265358979323846;
+        double x = k * 2.0 * pi / COMPRESION;
+        if (x >= pi / 2.0)
+        {
+            return 1.0;
+        }
+        return (std::sin(x) + 1.0) / 2.0;
+    }
+};
+
+/**
+ * @brief Conjunto de estimadores en flujo de un sensor
+ *
+ * Se actualiza en cada lectura ingerida y ofrece media, desviación estándar
+ * y cuantiles (p50/p95/p99) sin recorrer ni ordenar el historial. Dos
+ * instancias se pueden fusionar para obtener estadísticas combinadas.
+ */
+class EstadisticaFlujo {
+private:
+    EstimadorVarianza varianza;  ///< Media, varianza y extremos
+    DigestoCuantiles digesto;    ///< Distribución aproximada
+
+public:
+    /**
+     * @brief Constructor por defecto (sin lecturas)
+     */
+    EstadisticaFlujo() {}
+
+    /**
+     * @brief Constructor a partir de estimadores ya calculados
+     * @param estimador Media, varianza y extremos
+     * @param distribucion Digesto de las mismas lecturas
+     */
+    EstadisticaFlujo(const EstimadorVarianza &estimador, const DigestoCuantiles &distribucion)
+        : varianza(estimador), digesto(distribucion) {}
+
+    /**
+     * @brief Incorpora una lectura
+     * @param valor Valor de la lectura
+     */
+    void agregar(double valor)
+    {
+        varianza.agregar(valor);
+        digesto.agregar(valor);
+    }
+
+    /**
+     * @brief Fusiona las estadísticas de otro conjunto en este
+     * @param otra Estadísticas a fusionar
+     */
+    void fusionar(const EstadisticaFlujo &otra)
+    {
+        varianza.fusionar(otra.varianza);
+        digesto.fusionar(otra.digesto);
+    }
+
+    long long obtenerCantidad() const { return varianza.obtenerCantidad(); }   ///< Lecturas ingeridas
+    double obtenerMedia() const { return varianza.obtenerMedia(); }            ///< Media de ingesta
+    double obtenerVarianza() const { return varianza.obtenerVarianza(); }      ///< Varianza muestral
+    double obtenerDesviacion() const { return varianza.obtenerDesviacion(); }  ///< Desviación estándar
+    double obtenerMinimo() const { return varianza.obtenerMinimo(); }          ///< Menor lectura
+    double obtenerMaximo() const { return varianza.obtenerMaximo(); }          ///< Mayor lectura
+    const EstimadorVarianza &obtenerEstimadorVarianza() const { return varianza; } ///< Media, varianza y extremos
+    const DigestoCuantiles &obtenerDigesto() const { return digesto; }             ///< Distribución aproximada
+
+    /**
+     * @brief Estima un cuantil de las lecturas ingeridas
+     * @param q Cuantil deseado en [0, 1] (p. ej. 0.95 para p95)
+     * @return Valor estimado
+     */
+    double cuantil(double q) const
+    {
+        return digesto.cuantil(q, varianza.obtenerMinimo(), varianza.obtenerMaximo());
+    }
+};
+
+#endif // ESTADISTICA_FLUJO_H
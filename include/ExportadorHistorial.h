@@ -0,0 +1,193 @@
+/**
+ * @file ExportadorHistorial.h
+ * @brief Volcado de historiales de sensores a archivo (CSV o columnas binarias)
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef EXPORTADOR_HISTORIAL_H
+#define EXPORTADOR_HISTORIAL_H
+
+#include "SensorBase.h"
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief Formato del archivo de exportación
+ */
+enum class FormatoExportacion : unsigned char {
+    CSV,      ///< Texto: una fila "sensor,tipo,indice,valor" por lectura (RFC 4180)
+    BINARIO   ///< Lecturas crudas little-endian precedidas por un encabezado por sensor
+};
+
+/**
+ * @brief Escritor de historiales completos a archivo
+ *
+ * Los valores se formatean con std::to_chars (independiente del locale; la
+ * representación más corta que reproduce el valor) en un búfer propio de
+ * TAM_BUFER bytes que se entrega al archivo en escrituras grandes, sin pasar
+ * por el búfer de stdio.
+ *
+ * Formato binario (enteros little-endian):
+ * - Archivo: magia "SIOTHIS" terminada en '\0' (8 bytes) y versión (uint32).
+ * - Por sensor: nombre (TAM_NOMBRE_SENSOR bytes, relleno con ceros), tipo
+ *   (uint8), bytes por lectura (uint8), 1 si es flotante (uint8), reservado
+ *   (uint8) y cantidad (uint64), seguidos de las lecturas (int32, float32
+ *   o float64 IEEE 754).
+ *
+ * Uso: abrir(), y por cada sensor comenzarSensor() seguido de exactamente
+ * `cantidad` llamadas a agregar(); al final cerrar().
+ */
+class ExportadorHistorial {
+public:
+    static const std::size_t TAM_BUFER = 1 << 20;  ///< Bytes acumulados por escritura
+    static const std::uint32_t VERSION = 1;        ///< Versión del formato binario
+
+private:
+    static const std::size_t MAX_FILA = 256;  ///< Cota de bytes de una fila CSV o lectura binaria
+
+    std::FILE* archivo;                    ///< Archivo de destino (nullptr = cerrado)
+    FormatoExportacion formato;            ///< Formato en curso
+    char* bufer;                           ///< Bytes pendientes de escribir
+    std::size_t ocupado;                   ///< Bytes ocupados del búfer
+    unsigned long long bytesEscritos;      ///< Bytes entregados al archivo
+    unsigned long long lecturasEscritas;   ///< Lecturas exportadas
+    bool error;                            ///< Si alguna escritura falló
+    char prefijo[2 * TAM_NOMBRE_SENSOR + 32];  ///< "sensor,tipo," del sensor en curso (CSV)
+    std::size_t tamPrefijo;                ///< Bytes de prefijo
+    unsigned long long indice;             ///< Índice de la siguiente lectura del sensor
+
+public:
+    /**
+     * @brief Constructor
+     */
+    ExportadorHistorial();
+
+    /**
+     * @brief Destructor - cierra el archivo si sigue abierto
+     */
+    ~ExportadorHistorial();
+
+    /**
+     * @brief Crea (o trunca) el archivo de destino y escribe su encabezado
+     * @param ruta Ruta del archivo
+     * @param formato Formato de exportación
+     * @return true si el archivo quedó abierto
+     */
+    bool abrir(const char* ruta, FormatoExportacion formato);
+
+    /**
+     * @brief Vacía el búfer y cierra el archivo
+     * @return true si todas las escrituras tuvieron éxito
+     */
+    bool cerrar();
+
+    /**
+     * @brief Indica si hay un archivo abierto
+     * @return true si hay un archivo abierto
+     */
+    bool estaAbierto() const;
+
+    /**
+     * @brief Comienza el historial de un sensor
+     * @param nombre Nombre del sensor
+     * @param tipo Tipo del sensor
+     * @param bytesLectura Tamaño de cada lectura (4 u 8)
+     * @param flotante true si las lecturas son de punto flotante
+     * @param cantidad Lecturas que seguirán
+     */
+    void comenzarSensor(const char* nombre, TipoSensor tipo, int bytesLectura, bool flotante, int cantidad);
+
+    /**
+     * @brief Agrega una lectura entera al sensor en curso
+     * @param valor Lectura
+     */
+    void agregar(int valor) { agregarValor(valor); }
+
+    /**
+     * @brief Agrega una lectura float al sensor en curso
+     * @param valor Lectura
+     */
+    void agregar(float valor) { agregarValor(valor); }
+
+    /**
+     * @brief Agrega una lectura double al sensor en curso
+     * @param valor Lectura
+     */
+    void agregar(double valor) { agregarValor(valor); }
+
+    /**
+     * @brief Obtiene los bytes entregados al archivo
+     * @return Bytes escritos
+     */
+    unsigned long long obtenerBytesEscritos() const;
+
+    /**
+     * @brief Obtiene las lecturas exportadas desde abrir()
+     * @return Lecturas escritas
+     */
+    unsigned long long obtenerLecturasEscritas() const;
+
+private:
+    /**
+     * @brief Formatea una lectura en el búfer (ruta caliente, en línea)
+     * @tparam T Tipo de la lectura
+     * @param valor Lectura
+     */
+    template <typename T>
+    void agregarValor(T valor);
+
+    /**
+     * @brief Escribe un entero little-endian en el búfer
+     * @param valor Valor a escribir
+     * @param bytes Bytes a escribir (1..8)
+     */
+    void escribirEntero(std::uint64_t valor, int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            bufer[ocupado++] = static_cast<char>((valor >> (8 * i)) & 0xFF);
+        }
+    }
+
+    /**
+     * @brief Entrega el búfer al archivo
+     */
+    void vaciar();
+
+    ExportadorHistorial(const ExportadorHistorial&);             ///< No copiable
+    ExportadorHistorial& operator=(const ExportadorHistorial&);  ///< No asignable
+};
+
+template <typename T>
+void ExportadorHistorial::agregarValor(T valor) {
+    if (TAM_BUFER - ocupado < MAX_FILA) {
+        vaciar();
+    }
+
+    if (formato == FormatoExportacion::BINARIO) {
+        if constexpr (sizeof(T) == 8) {
+            std::uint64_t bits;
+            std::memcpy(&bits, &valor, sizeof(bits));
+            escribirEntero(bits, 8);
+        } else {
+            std::uint32_t bits;
+            std::memcpy(&bits, &valor, sizeof(bits));
+            escribirEntero(bits, 4);
+        }
+    } else {
+        char* destino = bufer + ocupado;
+        char* fin = bufer + TAM_BUFER;
+        std::memcpy(destino, prefijo, tamPrefijo);
+        destino += tamPrefijo;
+        destino = std::to_chars(destino, fin, indice).ptr;
+        *destino++ = ',';
+        destino = std::to_chars(destino, fin, valor).ptr;
+        *destino++ = '\n';
+        ocupado = static_cast<std::size_t>(destino - bufer);
+    }
+    indice++;
+    lecturasEscritas++;
+}
+
+#endif // EXPORTADOR_HISTORIAL_H
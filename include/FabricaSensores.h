@@ -0,0 +1,67 @@
+/**
+ * @file FabricaSensores.h
+ * @brief Alta, conversión de lecturas y búsqueda por texto de los tipos de sensor
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef FABRICA_SENSORES_H
+#define FABRICA_SENSORES_H
+
+#include "SensorBase.h"
+#include <cstddef>
+#include <iostream>
+
+/**
+ * @brief Crea un sensor del tipo indicado
+ * @param tipo Etiqueta del tipo
+ * @param nombre Nombre del sensor
+ * @return Sensor nuevo (el llamador lo libera), o nullptr si el tipo no está en la tabla
+ */
+SensorBase* crearSensor(TipoSensor tipo, const char* nombre);
+
+/**
+ * @brief Valida y convierte una lectura al tipo de dato de un tipo de sensor
+ *
+ * Aplica la misma conversión que el sensor al registrarla; permite rechazar
+ * un valor antes de dar de alta su sensor.
+ *
+ * @param tipo Etiqueta del tipo
+ * @param valor Lectura recibida
+ * @param lectura Recibe el valor convertido
+ * @return true si el valor es finito y cabe en el tipo de lectura del sensor
+ */
+bool convertirLectura(TipoSensor tipo, double valor, double& lectura);
+
+/**
+ * @brief Nombre del tipo de dato de las lecturas de un tipo de sensor
+ * @param tipo Etiqueta del tipo
+ * @return "float", "int", ...
+ */
+const char* nombreTipoLectura(TipoSensor tipo);
+
+/**
+ * @brief Busca un tipo de sensor por su clave de texto
+ * @param clave Clave del tipo (rasgosTipoSensor().clave, p. ej. "presion")
+ * @param tipo Recibe la etiqueta del tipo
+ * @return true si la clave corresponde a un tipo
+ */
+bool buscarTipoPorClave(const char* clave, TipoSensor& tipo);
+
+/**
+ * @brief Busca un tipo de sensor por su prefijo de ingesta
+ * @param prefijo Inicio del prefijo (no necesita terminador nulo)
+ * @param largo Caracteres del prefijo
+ * @param tipo Recibe la etiqueta del tipo
+ * @return true si el prefijo corresponde a un tipo
+ */
+bool buscarTipoPorPrefijo(const char* prefijo, std::size_t largo, TipoSensor& tipo);
+
+/**
+ * @brief Escribe las claves de todos los tipos separadas por '|'
+ * @param salida Flujo de salida
+ * @param antes Texto antepuesto a cada clave (p. ej. "tipo:")
+ */
+void escribirClavesTipos(std::ostream& salida, const char* antes);
+
+#endif // FABRICA_SENSORES_H
@@ -0,0 +1,120 @@
+/**
+ * @file GestorEpocas.h
+ * @brief Recuperación de memoria basada en épocas para lecturas concurrentes
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef GESTOR_EPOCAS_H
+#define GESTOR_EPOCAS_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Registro global de épocas de los hilos lectores
+ *
+ * Un lector anuncia la época vigente al entrar en una sección de lectura y
+ * la retira al salir; mientras tanto, nada de lo que pudo alcanzar se libera.
+ * Un objeto desenlazado y retirado en la época e puede liberarse cuando la
+ * época global llega a e + 2: para entonces todos los lectores que podían
+ * verlo ya salieron. Los lectores nunca esperan al escritor y el escritor
+ * solo espera a los lectores en sincronizar().
+ */
+class GestorEpocas {
+public:
+    static const int MAX_HILOS = 64;  ///< Hilos lectores registrables a la vez
+
+private:
+    static const std::uint64_t ACTIVO = 1;  ///< Bit de ranura en sección de lectura
+
+    /**
+     * @brief Estado de un hilo registrado (época << 1 | ACTIVO)
+     */
+    struct alignas(64) RanuraHilo {
+        std::atomic<std::uint64_t> estado;  ///< Época anunciada y bit de actividad
+        std::atomic<bool> ocupada;          ///< Si un hilo tiene asignada la ranura
+    };
+
+    alignas(64) std::atomic<std::uint64_t> epoca;  ///< Época global
+    RanuraHilo ranuras[MAX_HILOS];                 ///< Una ranura por hilo lector
+
+public:
+    /**
+     * @brief Instancia compartida por todas las listas del proceso
+     * @return Referencia al gestor global
+     */
+    static GestorEpocas& global();
+
+    /**
+     * @brief Entra en una sección de lectura (admite anidamiento)
+     */
+    void entrar();
+
+    /**
+     * @brief Sale de una sección de lectura
+     */
+    void salir();
+
+    /**
+     * @brief Obtiene la época global
+     * @return Época actual
+     */
+    std::uint64_t epocaActual() const;
+
+    /**
+     * @brief Avanza la época global si ningún lector activo quedó atrás
+     * @return Época global tras el intento
+     */
+    std::uint64_t intentarAvanzar();
+
+    /**
+     * @brief Espera a que todos los lectores activos salgan (período de gracia)
+     *
+     * Al volver, cualquier objeto retirado antes de la llamada es liberable.
+     */
+    void sincronizar();
+
+    /**
+     * @brief Libera la ranura de un hilo que termina
+     * @param ranura Índice de la ranura
+     */
+    void liberarRanura(int ranura);
+
+private:
+    /**
+     * @brief Constructor (solo para global())
+     */
+    GestorEpocas();
+
+    /**
+     * @brief Toma una ranura libre para el hilo que llama
+     * @return Índice de la ranura
+     */
+    int tomarRanura();
+
+    GestorEpocas(const GestorEpocas&);             ///< No copiable
+    GestorEpocas& operator=(const GestorEpocas&);  ///< No asignable
+};
+
+/**
+ * @brief Sección de lectura con alcance léxico (RAII)
+ */
+class GuardiaEpoca {
+public:
+    /**
+     * @brief Entra en la sección de lectura
+     */
+    GuardiaEpoca() { GestorEpocas::global().entrar(); }
+
+    /**
+     * @brief Sale de la sección de lectura
+     */
+    ~GuardiaEpoca() { GestorEpocas::global().salir(); }
+
+private:
+    GuardiaEpoca(const GuardiaEpoca&);             ///< No copiable
+    GuardiaEpoca& operator=(const GuardiaEpoca&);  ///< No asignable
+};
+
+#endif // GESTOR_EPOCAS_H
@@ -0,0 +1,490 @@
+/**
+ * @file IndiceValores.h
+ * @brief Índice de conteo por valor para las búsquedas en el historial
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef INDICE_VALORES_H
+#define INDICE_VALORES_H
+
+#include "GestorEpocas.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Cuántas veces aparece cada valor en una ListaSensor<T>
+ *
+ * Cada valor lleva dos contadores: lecturas en bloques sellados y lecturas en
+ * la cola activa de nodos, de forma que buscar responde sin recorrer el
+ * historial y eliminar sabe si necesita decodificar bloques.
+ *
+ * - Para T entero se puede configurar un dominio denso [minimo, maximo]: un
+ *   arreglo de contadores indexado por (valor - minimo), O(1) por operación.
+ * - Los valores fuera del dominio denso (y todos los de T flotante) van a un
+ *   arreglo ordenado de valores distintos con búsqueda binaria. Un valor nuevo
+ *   se inserta en una copia del arreglo, que se publica atómicamente; la
+ *   versión anterior se retira con GestorEpocas, así los lectores buscan sin
+ *   candados. Como cada valor distinto nuevo cuesta una copia, el arreglo se
+ *   limita a MAX_DISTINTOS valores: al superarlo (o al recibir NaN) el índice
+ *   queda saturado y contar() responde -1 para los valores que no conoce.
+ *
+ * Solo el hilo escritor de la lista modifica el índice; contar() puede
+ * llamarse desde cualquier hilo.
+ *
+ * @tparam T Tipo de dato de las lecturas
+ */
+template <typename T>
+class IndiceValores
+{
+public:
+    static const int MAX_DOMINIO_DENSO = 1 << 16; ///< Contadores densos como máximo
+    static const int MAX_DISTINTOS = 4096;        ///< Valores distintos en el arreglo ordenado
+
+private:
+    /**
+     * @brief Contadores de un valor
+     */
+    struct Conteo
+    {
+        std::atomic<int> enBloques; ///< Lecturas en bloques sellados
+        std::atomic<int> enNodos;   ///< Lecturas en la cola activa
+    };
+
+    /**
+     * @brief Arreglo ordenado de valores distintos (inmutable salvo sus contadores)
+     */
+    struct Ordenado
+    {
+        int cantidad;    ///< Valores distintos
+        int capacidad;   ///< Entradas reservadas
+        T *valores;      ///< Valores en orden ascendente
+        Conteo *conteos; ///< Contadores de cada valor
+    };
+
+    /**
+     * @brief Arreglo reemplazado a la espera de que salgan sus lectores
+     */
+    struct Retiro
+    {
+        Ordenado *arreglo;   ///< Arreglo retirado
+        std::uint64_t epoca; ///< Época de retiro
+    };
+
+    Conteo *denso;                   ///< Contadores del dominio denso (nullptr = sin dominio)
+    long long minimoDenso;           ///< Primer valor del dominio denso
+    long long maximoDenso;           ///< Último valor del dominio denso
+    std::atomic<Ordenado *> ordenado; ///< Arreglo ordenado vigente (nullptr = vacío)
+    std::atomic<bool> saturado;      ///< Si hay valores que el índice no registra
+    Retiro *retirados;               ///< Arreglos pendientes de liberar
+    int numRetirados;                ///< Entradas ocupadas de retirados
+    int capacidadRetirados;          ///< Entradas reservadas de retirados
+
+public:
+    /**
+     * @brief Constructor (índice vacío, sin dominio denso)
+     */
+    IndiceValores() : denso(nullptr), minimoDenso(0), maximoDenso(-1), ordenado(nullptr), saturado(false),
+                      retirados(nullptr), numRetirados(0), capacidadRetirados(0) {}
+
+    /**
+     * @brief Destructor - el dueño garantiza que ya no hay lectores
+     */
+    ~IndiceValores()
+    {
+        delete[] denso;
+        liberarArreglo(ordenado.load());
+        for (int i = 0; i < numRetirados; i++)
+        {
+            liberarArreglo(retirados[i].arreglo);
+        }
+        delete[] retirados;
+    }
+
+    /**
+     * @brief Define el dominio de conteo denso (solo tipos enteros, índice vacío)
+     *
+     * Dominios de más de MAX_DOMINIO_DENSO valores se recortan desde minimo.
+     *
+     * @param minimo Primer valor del dominio
+     * @param maximo Último valor del dominio (menor que minimo = sin dominio)
+     */
+    void configurarDominio(long long minimo, long long maximo)
+    {
+        if (!std::is_integral<T>::value || maximo < minimo)
+        {
+            return;
+        }
+        if (maximo - minimo >= MAX_DOMINIO_DENSO)
+        {
+            maximo = minimo + MAX_DOMINIO_DENSO - 1;
+        }
+        int rango = static_cast<int>(maximo - minimo + 1);
+        delete[] denso;
+        denso = new Conteo[rango];
+        for (int i = 0; i < rango; i++)
+        {
+            denso[i].enBloques.store(0, std::memory_order_relaxed);
+            denso[i].enNodos.store(0, std::memory_order_relaxed);
+        }
+        minimoDenso = minimo;
+        maximoDenso = maximo;
+    }
+
+    /**
+     * @brief Primer valor del dominio denso
+     * @return Mínimo configurado
+     */
+    long long obtenerMinimoDenso() const { return minimoDenso; }
+
+    /**
+     * @brief Último valor del dominio denso
+     * @return Máximo configurado (menor que el mínimo si no hay dominio)
+     */
+    long long obtenerMaximoDenso() const { return maximoDenso; }
+
+    /**
+     * @brief Registra una lectura nueva
+     * @param valor Valor de la lectura
+     * @param enBloque true si la lectura está en un bloque sellado
+     */
+    void agregar(const T &valor, bool enBloque)
+    {
+        Conteo *conteo = ubicarOInsertar(valor);
+        if (conteo != nullptr)
+        {
+            incrementar(enBloque ? conteo->enBloques : conteo->enNodos, 1);
+        }
+    }
+
+    /**
+     * @brief Registra la eliminación de una lectura
+     * @param valor Valor de la lectura
+     * @param enBloque true si estaba en un bloque sellado
+     */
+    void quitar(const T &valor, bool enBloque)
+    {
+        Conteo *conteo = ubicar(valor);
+        if (conteo != nullptr)
+        {
+            incrementar(enBloque ? conteo->enBloques : conteo->enNodos, -1);
+        }
+    }
+
+    /**
+     * @brief Registra que una lectura pasó de la cola activa a un bloque sellado
+     * @param valor Valor de la lectura
+     */
+    void sellar(const T &valor)
+    {
+        Conteo *conteo = ubicar(valor);
+        if (conteo != nullptr)
+        {
+            // Primero el bloque: un lector nunca ve la lectura ausente
+            incrementar(conteo->enBloques, 1);
+            incrementar(conteo->enNodos, -1);
+        }
+    }
+
+    /**
+     * @brief Cuenta las lecturas con un valor (desde cualquier hilo)
+     * @param valor Valor buscado
+     * @return Número de lecturas, o -1 si el índice no puede saberlo
+     */
+    int contar(const T &valor) const
+    {
+        GuardiaEpoca guardia;
+        const Conteo *conteo = ubicar(valor);
+        if (conteo == nullptr)
+        {
+            return saturado.load(std::memory_order_acquire) ? -1 : 0;
+        }
+        // Nodos antes que bloques: un sellado concurrente nunca se cuenta como cero
+        int enNodos = conteo->enNodos.load(std::memory_order_relaxed);
+        return enNodos + conteo->enBloques.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Cuenta las lecturas con un valor que están en bloques sellados
+     * @param valor Valor buscado
+     * @return Número de lecturas, o -1 si el índice no puede saberlo
+     */
+    int contarEnBloques(const T &valor) const
+    {
+        const Conteo *conteo = ubicar(valor);
+        if (conteo == nullptr)
+        {
+            return saturado.load(std::memory_order_relaxed) ? -1 : 0;
+        }
+        return conteo->enBloques.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Obtiene el menor valor con lecturas (hilo escritor)
+     * @param valor Recibe el mínimo
+     * @return false si el índice está vacío o saturado
+     */
+    bool minimo(T &valor) const
+    {
+        if (saturado.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+        bool hayMinimo = false;
+        int rango = denso != nullptr ? static_cast<int>(maximoDenso - minimoDenso + 1) : 0;
+        for (int i = 0; i < rango; i++)
+        {
+            if (tieneLecturas(denso[i]))
+            {
+                valor = static_cast<T>(minimoDenso + i);
+                hayMinimo = true;
+                break;
+            }
+        }
+        // Los valores fuera del dominio denso pueden quedar por debajo de él
+        const Ordenado *arreglo = ordenado.load(std::memory_order_relaxed);
+        for (int i = 0; arreglo != nullptr && i < arreglo->cantidad; i++)
+        {
+            if (tieneLecturas(arreglo->conteos[i]))
+            {
+                if (!hayMinimo || arreglo->valores[i] < valor)
+                {
+                    valor = arreglo->valores[i];
+                    hayMinimo = true;
+                }
+                break;
+            }
+        }
+        return hayMinimo;
+    }
+
+    /**
+     * @brief Vacía el índice conservando el dominio denso
+     */
+    void limpiar()
+    {
+        int rango = denso != nullptr ? static_cast<int>(maximoDenso - minimoDenso + 1) : 0;
+        for (int i = 0; i < rango; i++)
+        {
+            denso[i].enBloques.store(0, std::memory_order_relaxed);
+            denso[i].enNodos.store(0, std::memory_order_relaxed);
+        }
+        Ordenado *anterior = ordenado.load(std::memory_order_relaxed);
+        ordenado.store(nullptr, std::memory_order_release);
+        saturado.store(false, std::memory_order_release);
+        if (anterior != nullptr)
+        {
+            retirar(anterior);
+        }
+    }
+
+    /**
+     * @brief Memoria ocupada por el índice
+     * @return Bytes de contadores y valores
+     */
+    std::size_t memoria() const
+    {
+        GuardiaEpoca guardia;
+        std::size_t bytes = 0;
+        if (denso != nullptr)
+        {
+            bytes += static_cast<std::size_t>(maximoDenso - minimoDenso + 1) * sizeof(Conteo);
+        }
+        const Ordenado *arreglo = ordenado.load(std::memory_order_acquire);
+        if (arreglo != nullptr)
+        {
+            bytes += sizeof(Ordenado) + static_cast<std::size_t>(arreglo->capacidad) * (sizeof(T) + sizeof(Conteo));
+        }
+        return bytes;
+    }
+
+private:
+    /**
+     * @brief Suma a un contador (solo el escritor modifica los contadores)
+     * @param contador Contador a modificar
+     * @param delta Cantidad a sumar
+     */
+    static void incrementar(std::atomic<int> &contador, int delta)
+    {
+        contador.store(contador.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Indica si un valor tiene lecturas
+     * @param conteo Contadores del valor
+     * @return true si alguna lectura tiene el valor
+     */
+    static bool tieneLecturas(const Conteo &conteo)
+    {
+        return conteo.enNodos.load(std::memory_order_relaxed) + conteo.enBloques.load(std::memory_order_relaxed) > 0;
+    }
+
+    /**
+     * @brief Localiza los contadores de un valor
+     * @param valor Valor buscado
+     * @return Contadores, o nullptr si el valor no está registrado
+     */
+    Conteo *ubicar(const T &valor) const
+    {
+        if constexpr (std::is_integral<T>::value)
+        {
+            long long desplazamiento = static_cast<long long>(valor) - minimoDenso;
+            if (denso != nullptr && desplazamiento >= 0 && desplazamiento <= maximoDenso - minimoDenso)
+            {
+                return &denso[desplazamiento];
+            }
+        }
+        Ordenado *arreglo = ordenado.load(std::memory_order_acquire);
+        if (arreglo == nullptr)
+        {
+            return nullptr;
+        }
+        int posicion = posicionDe(arreglo, valor);
+        if (posicion < arreglo->cantidad && arreglo->valores[posicion] == valor)
+        {
+            return &arreglo->conteos[posicion];
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Localiza los contadores de un valor, registrándolo si es nuevo
+     * @param valor Valor de la lectura
+     * @return Contadores, o nullptr si el índice está saturado
+     */
+    Conteo *ubicarOInsertar(const T &valor)
+    {
+        Conteo *conteo = ubicar(valor);
+        if (conteo != nullptr || saturado.load(std::memory_order_relaxed))
+        {
+            return conteo;
+        }
+
+        Ordenado *anterior = ordenado.load(std::memory_order_relaxed);
+        int cantidad = anterior != nullptr ? anterior->cantidad : 0;
+        if (!(valor == valor) || cantidad >= MAX_DISTINTOS)
+        {
+            saturado.store(true, std::memory_order_release);
+            return nullptr;
+        }
+
+        // Copia con el valor nuevo en su posición; los lectores siguen en la anterior
+        int capacidad = anterior != nullptr ? anterior->capacidad : 0;
+        if (cantidad + 1 > capacidad)
+        {
+            capacidad = capacidad > 0 ? capacidad * 2 : 16;
+        }
+        Ordenado *nuevo = new Ordenado;
+        nuevo->cantidad = cantidad + 1;
+        nuevo->capacidad = capacidad;
+        nuevo->valores = new T[capacidad];
+        nuevo->conteos = new Conteo[capacidad];
+
+        int posicion = anterior != nullptr ? posicionDe(anterior, valor) : 0;
+        for (int i = 0, j = 0; i < nuevo->cantidad; i++)
+        {
+            if (i == posicion)
+            {
+                nuevo->valores[i] = valor;
+                nuevo->conteos[i].enBloques.store(0, std::memory_order_relaxed);
+                nuevo->conteos[i].enNodos.store(0, std::memory_order_relaxed);
+                continue;
+            }
+            nuevo->valores[i] = anterior->valores[j];
+            nuevo->conteos[i].enBloques.store(anterior->conteos[j].enBloques.load(std::memory_order_relaxed),
+                                              std::memory_order_relaxed);
+            nuevo->conteos[i].enNodos.store(anterior->conteos[j].enNodos.load(std::memory_order_relaxed),
+                                            std::memory_order_relaxed);
+            j++;
+        }
+
+        ordenado.store(nuevo, std::memory_order_release);
+        if (anterior != nullptr)
+        {
+            retirar(anterior);
+        }
+        return &nuevo->conteos[posicion];
+    }
+
+    /**
+     * @brief Primera posición del arreglo cuyo valor no es menor que valor
+     * @param arreglo Arreglo ordenado
+     * @param valor Valor buscado
+     * @return Posición en [0, cantidad]
+     */
+    static int posicionDe(const Ordenado *arreglo, const T &valor)
+    {
+        int inicio = 0;
+        int fin = arreglo->cantidad;
+        while (inicio < fin)
+        {
+            int medio = inicio + (fin - inicio) / 2;
+            if (arreglo->valores[medio] < valor)
+            {
+                inicio = medio + 1;
+            }
+            else
+            {
+                fin = medio;
+            }
+        }
+        return inicio;
+    }
+
+    /**
+     * @brief Retira un arreglo reemplazado y libera los que ya no tienen lectores
+     * @param arreglo Arreglo que dejó de estar publicado
+     */
+    void retirar(Ordenado *arreglo)
+    {
+        if (numRetirados == capacidadRetirados)
+        {
+            int nuevaCapacidad = capacidadRetirados > 0 ? capacidadRetirados * 2 : 8;
+            Retiro *nuevos = new Retiro[nuevaCapacidad];
+            for (int i = 0; i < numRetirados; i++)
+            {
+                nuevos[i] = retirados[i];
+            }
+            delete[] retirados;
+            retirados = nuevos;
+            capacidadRetirados = nuevaCapacidad;
+        }
+        retirados[numRetirados].arreglo = arreglo;
+        retirados[numRetirados].epoca = GestorEpocas::global().epocaActual();
+        numRetirados++;
+
+        std::uint64_t epoca = GestorEpocas::global().intentarAvanzar();
+        int liberados = 0;
+        while (liberados < numRetirados && retirados[liberados].epoca + 2 <= epoca)
+        {
+            liberarArreglo(retirados[liberados].arreglo);
+            liberados++;
+        }
+        for (int i = liberados; i < numRetirados; i++)
+        {
+            retirados[i - liberados] = retirados[i];
+        }
+        numRetirados -= liberados;
+    }
+
+    /**
+     * @brief Libera un arreglo ordenado
+     * @param arreglo Arreglo a liberar (puede ser nullptr)
+     */
+    static void liberarArreglo(Ordenado *arreglo)
+    {
+        if (arreglo != nullptr)
+        {
+            delete[] arreglo->valores;
+            delete[] arreglo->conteos;
+            delete arreglo;
+        }
+    }
+
+    IndiceValores(const IndiceValores &);            ///< No copiable
+    IndiceValores &operator=(const IndiceValores &); ///< No asignable
+};
+
+#endif // INDICE_VALORES_H
@@ -0,0 +1,129 @@
+/**
+ * @file LectorMemoria.h
+ * @brief Lectura de solo lectura del segmento compartido de sensores
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef LECTOR_MEMORIA_H
+#define LECTOR_MEMORIA_H
+
+#include "SegmentoSensores.h"
+
+/**
+ * @brief Lector del segmento publicado por PublicadorMemoria
+ *
+ * Mapea el segmento con PROT_READ: nunca escribe en él y nunca espera al
+ * escritor. Las estadísticas se obtienen reintentando el seqlock de la
+ * ranura; las lecturas recientes se recorren directamente sobre el anillo
+ * compartido, sin copiarlo.
+ */
+class LectorMemoria {
+private:
+    const void* mapeo;                  ///< Inicio del segmento mapeado
+    std::size_t tamano;                 ///< Bytes mapeados
+    const RanuraSensor* ranuras;        ///< Primera ranura del segmento
+    std::uint32_t numRanuras;           ///< Ranuras del segmento
+    std::int64_t pidEscritor;           ///< Proceso que publica el segmento
+
+public:
+    /**
+     * @brief Constructor (no mapea el segmento)
+     */
+    LectorMemoria();
+
+    /**
+     * @brief Destructor - desmapea el segmento
+     */
+    ~LectorMemoria();
+
+    /**
+     * @brief Mapea en solo lectura un segmento existente
+     * @param nombre Nombre POSIX del segmento
+     * @return true si el segmento existe y su disposición es compatible
+     */
+    bool abrir(const char* nombre);
+
+    /**
+     * @brief Desmapea el segmento
+     */
+    void cerrar();
+
+    /**
+     * @brief Obtiene el número de ranuras del segmento
+     * @return Ranuras (0 si no hay segmento abierto)
+     */
+    int obtenerNumRanuras() const;
+
+    /**
+     * @brief Obtiene el proceso que publica el segmento
+     * @return PID del escritor
+     */
+    long long obtenerPidEscritor() const;
+
+    /**
+     * @brief Obtiene una instantánea coherente de las estadísticas de una ranura
+     * @param ranura Índice de la ranura (manejador del sensor)
+     * @param estadisticas Recibe la instantánea
+     * @return true si la ranura está activa
+     */
+    bool leerEstadisticas(int ranura, EstadisticaPublicada& estadisticas) const;
+
+    /**
+     * @brief Busca la ranura activa de un sensor por nombre
+     * @param nombre Nombre del sensor
+     * @return Índice de la ranura, o -1 si no se publica
+     */
+    int buscar(const char* nombre) const;
+
+    /**
+     * @brief Recorre en su lugar las lecturas recientes de una ranura
+     *
+     * Se visitan de la más antigua a la más reciente. Una lectura solo se
+     * entrega si, tras leerla, el escritor todavía no pudo sobrescribirla.
+     *
+     * @tparam F Función invocable con (double)
+     * @param ranura Índice de la ranura
+     * @param visitar Función a aplicar a cada lectura
+     * @return Número de lecturas visitadas
+     */
+    template <typename F>
+    int recorrerRecientes(int ranura, F visitar) const;
+
+private:
+    LectorMemoria(const LectorMemoria&);             ///< No copiable
+    LectorMemoria& operator=(const LectorMemoria&);  ///< No asignable
+};
+
+template <typename F>
+int LectorMemoria::recorrerRecientes(int ranura, F visitar) const {
+    EstadisticaPublicada estadisticas;
+    if (!leerEstadisticas(ranura, estadisticas)) {
+        return 0;
+    }
+
+    const RanuraSensor& actual = ranuras[ranura];
+    const std::uint64_t capacidad = RanuraSensor::LECTURAS_RECIENTES;
+    std::uint64_t hasta = actual.escritas.load(std::memory_order_acquire);
+    std::uint64_t desde = hasta > capacidad ? hasta - capacidad + 1 : 0;
+    if (desde < estadisticas.inicioAnillo) {
+        desde = estadisticas.inicioAnillo;
+    }
+
+    int visitadas = 0;
+    for (std::uint64_t i = desde; i < hasta; i++) {
+        double valor = actual.anillo[i % capacidad].load(std::memory_order_acquire);
+
+        // Si el escritor avanzó una vuelta, la posición ya tiene una lectura más nueva
+        std::uint64_t escritas = actual.escritas.load(std::memory_order_relaxed);
+        if (escritas >= capacidad && i <= escritas - capacidad) {
+            i = escritas - capacidad;
+            continue;
+        }
+        visitar(valor);
+        visitadas++;
+    }
+    return visitadas;
+}
+
+#endif // LECTOR_MEMORIA_H
@@ -0,0 +1,320 @@
+/**
+ * @file ListaGestion.h
+ * @brief Gestión polimórfica de sensores respaldada por un registro columnar
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef LISTA_GESTION_H
+#define LISTA_GESTION_H
+
+#include "SensorBase.h"
+#include "RegistroColumnar.h"
+#include "MotorReglas.h"
+#include "PublicadorMemoria.h"
+#include "ExportadorHistorial.h"
+#include "PoolHilos.h"
+
+/**
+ * @brief Predicado para la baja masiva de sensores
+ * @param resumen Fila del registro a evaluar
+ * @param contexto Dato opaco suministrado por el llamador
+ * @return true si el sensor debe darse de baja
+ */
+typedef bool (*PredicadoSensor)(const ResumenSensor& resumen, void* contexto);
+
+/**
+ * @brief Clase para gestionar la colección polimórfica de sensores
+ *
+ * Es dueña de los sensores (SensorBase*) y delega sus metadatos en un
+ * RegistroColumnar, de forma que la búsqueda por nombre es de tiempo constante
+ * y los recorridos de la flota avanzan linealmente por columnas contiguas.
+ * Cada lectura ingerida se evalúa contra el MotorReglas y las alertas quedan
+ * en su cola hasta que se atienden.
+ */
+class ListaGestion {
+private:
+    RegistroColumnar registro;     ///< Metadatos en columnas e historiales por manejador
+    int lecturasPorBloque;         ///< Compresión aplicada a los sensores nuevos (0 = ninguna)
+    bool indiceHabilitado;         ///< Si los sensores nuevos llevan índice de valores
+    long long minimoIndice;        ///< Dominio denso del índice (sensores enteros)
+    long long maximoIndice;        ///< Fin del dominio denso (menor que minimoIndice = ninguno)
+    MotorReglas reglas;            ///< Reglas de alerta evaluadas en la ingesta
+    PublicadorMemoria publicador;  ///< Segmento compartido para procesos de consulta
+    mutable PoolHilos* hilos;      ///< Pool de las consultas de flota (se crea al necesitarlo)
+
+public:
+    /**
+     * @brief Constructor
+     */
+    ListaGestion();
+
+    /**
+     * @brief Destructor - libera todos los sensores
+     */
+    ~ListaGestion();
+
+    /**
+     * @brief Inserta un sensor en la lista de gestión
+     * @param sensor Puntero al sensor a insertar (la lista pasa a ser su dueña)
+     * @return true si se insertó, false si ya existe un sensor con ese nombre
+     *         (en cuyo caso el llamador conserva la propiedad del sensor)
+     */
+    bool insertarSensor(SensorBase* sensor);
+
+    /**
+     * @brief Da de alta los sensores listados en un manifiesto
+     *
+     * Cada línea describe un sensor: `tipo nombre [compresion=N] [reserva=N]`,
+     * con tipo `temperatura` o `presion`; `compresion` fija las lecturas por
+     * bloque de su historial (0 = sin compresión; por omisión, la de la lista)
+     * y `reserva` preasigna los nodos para esa cantidad de lecturas. Las
+     * líneas vacías y las que empiezan con `#` se ignoran.
+     *
+     * El archivo se lee de una vez y el registro se dimensiona para todas las
+     * líneas antes de insertar, de modo que el índice de nombres no se
+     * reconstruye durante la carga. Los mensajes por sensor se omiten: solo
+     * se informan las líneas rechazadas y un resumen.
+     *
+     * @param ruta Ruta del manifiesto
+     * @return Sensores dados de alta, o -1 si no se pudo leer el archivo
+     */
+    int cargarManifiesto(const char* ruta);
+
+    /**
+     * @brief Publica lecturas recientes y estadísticas en memoria compartida
+     *
+     * A partir de este momento cada alta, baja y lectura se refleja en el
+     * segmento, que los procesos de consulta mapean en solo lectura.
+     *
+     * @param nombreSegmento Nombre POSIX del segmento (empieza con '/')
+     * @param numRanuras Sensores publicables (manejadores 0..numRanuras-1); con
+     *        0 se toma la capacidad actual del registro, y al menos
+     *        PublicadorMemoria::RANURAS_POR_DEFECTO
+     * @return true si el segmento quedó abierto
+     */
+    bool habilitarPublicacion(const char* nombreSegmento, int numRanuras = 0);
+
+    /**
+     * @brief Define la compresión del historial de los sensores que se inserten
+     * @param lecturasPorBloque Lecturas por bloque sellado (0 = sin compresión)
+     */
+    void establecerCompresion(int lecturasPorBloque);
+
+    /**
+     * @brief Activa el índice de valores en los sensores que se inserten
+     * @param minimoDenso Primer valor del dominio de conteo denso (sensores enteros)
+     * @param maximoDenso Último valor del dominio denso (menor que minimoDenso = ninguno)
+     */
+    void establecerIndice(long long minimoDenso, long long maximoDenso);
+
+    /**
+     * @brief Busca un sensor por nombre
+     * @param nombre Nombre del sensor a buscar
+     * @return Puntero al sensor encontrado o nullptr si no existe
+     */
+    SensorBase* buscarSensor(const char* nombre) const;
+
+    /**
+     * @brief Obtiene el ID (manejador estable) de un sensor
+     * @param nombre Nombre del sensor
+     * @return ID del sensor, o RegistroColumnar::SIN_MANEJADOR si no existe
+     */
+    unsigned int buscarId(const char* nombre) const;
+
+    /**
+     * @brief Da de baja un sensor por nombre y libera su memoria de inmediato
+     * @param nombre Nombre del sensor
+     * @return true si el sensor existía y fue liberado
+     */
+    bool eliminarSensor(const char* nombre);
+
+    /**
+     * @brief Da de baja un sensor por ID y libera su memoria de inmediato
+     * @param id ID (manejador) del sensor
+     * @return true si el sensor existía y fue liberado
+     */
+    bool eliminarSensor(unsigned int id);
+
+    /**
+     * @brief Da de baja todos los sensores que cumplen un predicado
+     * @param predicado Función que decide qué sensores se eliminan
+     * @param contexto Dato opaco que se pasa al predicado
+     * @return Número de sensores eliminados
+     */
+    int eliminarSensoresSi(PredicadoSensor predicado, void* contexto);
+
+    /**
+     * @brief Da de baja los sensores sin lecturas en el intervalo indicado
+     *
+     * Un sensor sin lecturas cuenta desde el momento de su alta.
+     *
+     * @param segundos Antigüedad máxima permitida de la última lectura
+     * @return Número de sensores eliminados
+     */
+    int eliminarInactivos(double segundos);
+
+    /**
+     * @brief Registra una lectura en un sensor y actualiza sus estadísticas columnares
+     * @param nombre Nombre del sensor
+     * @param valor Valor de la lectura (se convierte al tipo del sensor)
+     * @return true si se registró; false si el sensor no existe o el valor
+     *         no es finito o no cabe en el tipo del sensor
+     */
+    bool registrarLectura(const char* nombre, double valor);
+
+    /**
+     * @brief Registra un lote de lecturas en un sensor
+     *
+     * Los valores no finitos o que no caben en el tipo del sensor se
+     * descartan sin afectar estadísticas, reglas ni publicación.
+     *
+     * @param nombre Nombre del sensor
+     * @param valores Lecturas en orden de llegada (se convierten al tipo del sensor)
+     * @param cantidad Número de lecturas del lote
+     * @return Lecturas registradas, o -1 si el sensor no existe
+     */
+    int registrarLecturas(const char* nombre, const double* valores, int cantidad);
+
+    /**
+     * @brief Registra una lectura con el formato de línea de los dispositivos
+     *
+     * El formato es `TIPO:NOMBRE:VALOR`, con TIPO el prefijo de ingesta del
+     * tipo de sensor (`TEMP`, `PRES`; por ejemplo `TEMP:T-001:23.5`). Si el
+     * sensor no existe se da de alta con ese tipo.
+     *
+     * @param linea Línea recibida (sin salto de línea)
+     * @return true si la lectura se registró; false si la línea es inválida,
+     *         el valor no es válido para el tipo o el sensor existente es de
+     *         otro tipo
+     */
+    bool ingerirLinea(const char* linea);
+
+    /**
+     * @brief Compila y agrega una regla de alerta
+     * @param especificacion Texto de la regla (ver Regla)
+     * @return Identificador de la regla, o -1 si la especificación es inválida
+     */
+    int agregarRegla(const char* especificacion);
+
+    /**
+     * @brief Da de baja una regla de alerta
+     * @param id Identificador de la regla
+     * @return true si la regla existía y estaba activa
+     */
+    bool eliminarRegla(int id);
+
+    /**
+     * @brief Muestra las reglas de alerta activas
+     */
+    void mostrarReglas() const;
+
+    /**
+     * @brief Extrae e imprime las alertas pendientes
+     * @return Número de alertas atendidas
+     */
+    int atenderAlertas();
+
+    /**
+     * @brief Exporta a archivo el historial de un sensor o de todos
+     * @param ruta Archivo de destino (se crea o se trunca)
+     * @param formato CSV o binario
+     * @param nombre Sensor a exportar, o nullptr para todos
+     * @return Sensores exportados, o -1 si el sensor no existe o el archivo
+     *         no pudo escribirse
+     */
+    int exportarHistoriales(const char* ruta, FormatoExportacion formato, const char* nombre = nullptr) const;
+
+    /**
+     * @brief Ejecuta el procesamiento polimórfico en todos los sensores
+     */
+    void ejecutarProcesamientoPolimorfico();
+
+    /**
+     * @brief Procesa solo los sensores que recibieron lecturas desde su último procesamiento
+     *
+     * Recorre la lista de pendientes del registro en lugar de toda la flota,
+     * así que el costo es proporcional a los sensores con datos nuevos. El
+     * resultado de cada sensor queda en obtenerUltimoProcesamiento().
+     *
+     * @return Número de sensores procesados
+     */
+    int ejecutarProcesamientoIncremental();
+
+    /**
+     * @brief Indica si algún sensor pudo recibir lecturas desde el último procesamiento
+     * @return true si la lista de pendientes del registro no está vacía
+     */
+    bool tieneLecturasNuevas() const;
+
+    /**
+     * @brief Muestra el nombre de todos los sensores y el promedio de promedios
+     */
+    void mostrarTodosSensores() const;
+
+    /**
+     * @brief Promedio de los promedios de ingesta de todos los sensores
+     * @return Promedio de promedios (0 si ningún sensor tiene lecturas)
+     */
+    double promedioDePromedios() const;
+
+    /**
+     * @brief Agrega las estadísticas de ingesta de los sensores seleccionados
+     *
+     * Se calcula en paralelo sobre las columnas del registro, sin tocar los
+     * historiales; el resultado es el mismo con cualquier número de hilos.
+     *
+     * @param consulta Selección de sensores
+     * @return Agregado de la selección
+     */
+    AgregadoFlota consultarFlota(const ConsultaFlota& consulta) const;
+
+    /**
+     * @brief Media, mínimo y máximo de todas las lecturas de un tipo de sensor
+     * @param tipo Tipo de sensor
+     * @return Agregado de los sensores de ese tipo
+     */
+    AgregadoFlota agregadoPorTipo(TipoSensor tipo) const;
+
+    /**
+     * @brief Cuenta los sensores de un tipo cuyo promedio cumple un filtro
+     * @param tipo Tipo de sensor
+     * @param filtro Condición sobre el promedio de ingesta
+     * @param umbral Umbral del filtro
+     * @return Número de sensores que cumplen
+     */
+    int contarSensoresConPromedio(TipoSensor tipo, FiltroPromedio filtro, double umbral) const;
+
+    /**
+     * @brief Obtiene el número de sensores registrados
+     * @return Número de sensores
+     */
+    int obtenerCantidad() const;
+
+    /**
+     * @brief Verifica si la lista está vacía
+     * @return true si está vacía, false en caso contrario
+     */
+    bool estaVacia() const;
+
+private:
+    /**
+     * @brief Quita un sensor del registro y lo libera
+     * @param id ID (manejador) del sensor
+     * @return true si el sensor existía
+     */
+    bool liberarSensor(unsigned int id);
+
+    /**
+     * @brief Registra un sensor y le aplica la configuración de historial
+     * @param sensor Sensor a registrar
+     * @param lecturasPorBloque Compresión de su historial (0 = ninguna)
+     * @return Manejador asignado, o RegistroColumnar::SIN_MANEJADOR si el nombre ya existe
+     */
+    unsigned int darDeAlta(SensorBase* sensor, int lecturasPorBloque);
+
+    ListaGestion(const ListaGestion&);             ///< No copiable
+    ListaGestion& operator=(const ListaGestion&);  ///< No asignable
+};
+
+#endif // LISTA_GESTION_H
@@ -9,18 +9,118 @@
 #define LISTA_SENSOR_H
 
 #include "Nodo.h"
+#include "PoolNodos.h"
+#include "BloqueHistorial.h"
+#include "EstadisticaFlujo.h"
+#include "GestorEpocas.h"
+#include "IndiceValores.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <type_traits>
 
 /**
  * @brief Clase genérica para lista enlazada simple de sensores
+ *
+ * Por defecto cada lectura ocupa un Nodo<T>. Con la compresión habilitada,
+ * cada vez que la cola activa de nodos alcanza el tamaño de bloque, sus
+ * lecturas se sellan en un BloqueHistorial<T> codificado y los nodos se
+ * liberan; las lecturas más antiguas viven así en bloques comprimidos y solo
+ * las más recientes siguen sin comprimir.
+ *
+ * Los nodos se toman de un PoolNodos<T> propio de la lista y la inserción al
+ * final es de tiempo constante gracias al puntero a la cola.
+ *
+ * Concurrencia: un único hilo escritor (insertar, insertarLote, eliminar,
+ * eliminarMinimo, habilitarCompresion, limpiar) y cualquier número de hilos
+ * lectores (buscar, calcularPromedio, imprimir, obtenerTamano,
+ * obtenerInstantaneaEstadisticas, memoriaResidente). Cada operación del
+ * escritor publica al terminar una cabecera bajo un seqlock; un lector copia
+ * esa cabecera y recorre solo lo que ella alcanza, dentro de una GuardiaEpoca.
+ * La cabecera es trivialmente copiable: lleva media, varianza y extremos por
+ * valor y el digesto de cuantiles como puntero a una copia inmutable, que se
+ * reemplaza y retira igual que los nodos y bloques.
+ * Los nodos y bloques alcanzables por una cabecera publicada nunca se
+ * modifican: eliminar copia el tramo anterior al elemento quitado y lo
+ * alcanzado por cabeceras viejas se retira y se libera cuando ningún lector
+ * puede seguir viéndolo. Así cada lector ve una instantánea coherente sin
+ * tomar un candado por el que espere el escritor.
+ *
+ * Opcionalmente (habilitarIndice) un IndiceValores<T> lleva la cuenta de
+ * cada valor, de modo que buscar responde sin recorrer el historial y
+ * eliminar y eliminarMinimo no decodifican bloques que no hacen falta.
+ *
  * @tparam T Tipo de dato que almacena la lista (int, float, double, etc.)
  */
 template <typename T>
 class ListaSensor
 {
+public:
+    static const int MAX_LECTURAS_BLOQUE = 1024; ///< Límite del tamaño de bloque sellado
+
 private:
-    Nodo<T> *cabeza; ///< Puntero al primer nodo de la lista
-    int tamano;      ///< Numero de elementos en la lista
+    /**
+     * @brief Vista publicada de la lista (lo único que leen los lectores)
+     */
+    struct Cabecera
+    {
+        BloqueHistorial<T> *primerBloque; ///< Bloque sellado más antiguo
+        int numBloques;                   ///< Bloques alcanzables desde primerBloque
+        Nodo<T> *cabeza;                  ///< Primer nodo de la cola activa
+        int numNodos;                     ///< Nodos alcanzables desde cabeza
+        int tamano;                       ///< Lecturas totales (bloques + nodos)
+        int lecturasPorBloque;            ///< Tamaño de bloque configurado
+        std::size_t bytesNodos;           ///< Memoria reservada por el pool de nodos
+        EstimadorVarianza varianza;       ///< Media, varianza y extremos a la fecha
+        const DigestoCuantiles *digesto;  ///< Copia inmutable del digesto (nullptr = sin lecturas)
+    };
+    static_assert(std::is_trivially_copyable<Cabecera>::value, "leerCabecera copia la cabecera con memcpy");
+
+    /**
+     * @brief Clase de objeto retirado
+     */
+    enum class Retirado : unsigned char
+    {
+        NODO,   ///< Nodo<T> del pool
+        BLOQUE, ///< BloqueHistorial<T>
+        DIGESTO ///< DigestoCuantiles publicado
+    };
+
+    static const int MAX_DIGESTOS_LIBRES = 4; ///< Digestos recolectados que se guardan para reutilizar
+
+    /**
+     * @brief Objeto desenlazado a la espera de que salgan sus lectores
+     */
+    struct Retiro
+    {
+        void *objeto;        ///< Objeto retirado
+        Retirado clase;      ///< Clase del objeto
+        std::uint64_t epoca; ///< Época de retiro (válida desde la publicación)
+    };
+
+    Nodo<T> *cabeza;                  ///< Puntero al primer nodo de la cola activa
+    Nodo<T> *cola;                    ///< Puntero al último nodo de la cola activa
+    PoolNodos<T> pool;                ///< Losas de las que se toman los nodos
+    int tamano;                       ///< Numero de elementos en la lista (bloques + nodos)
+    int numNodos;                     ///< Elementos en la cola activa sin comprimir
+    BloqueHistorial<T> *primerBloque; ///< Bloque sellado más antiguo
+    BloqueHistorial<T> *ultimoBloque; ///< Bloque sellado más reciente
+    int numBloques;                   ///< Bloques sellados en la cadena
+    int lecturasPorBloque;            ///< Tamaño de bloque (0 = compresión deshabilitada)
+    EstadisticaFlujo estadisticas;    ///< Estimadores sobre todas las lecturas insertadas
+    bool estadisticasCambiadas;       ///< Si el digesto publicado quedó atrás de estadisticas
+    std::atomic<IndiceValores<T> *> indice; ///< Conteo por valor (nullptr = sin índice)
+
+    std::atomic<unsigned int> secuencia;      ///< Seqlock de la vista publicada (impar = escribiendo)
+    Cabecera publicada;                       ///< Última cabecera publicada
+    DigestoCuantiles *digestosLibres[MAX_DIGESTOS_LIBRES]; ///< Digestos recolectados listos para reutilizar
+    int numDigestosLibres;                    ///< Entradas ocupadas de digestosLibres
+    Retiro *retirados;                        ///< Objetos pendientes de liberar (en orden de época)
+    int numRetirados;                         ///< Entradas ocupadas de retirados
+    int capacidadRetirados;                   ///< Entradas reservadas de retirados
+    int retiradosSinEpoca;                    ///< Primeras entradas aún sin época asignada
 
 public:
     /**
@@ -43,6 +143,9 @@ public:
 
     /**
      * @brief Destructor - libera toda la memoria
+     *
+     * Ningún lector puede seguir usando la lista mientras se destruye, así
+     * que lo retirado se libera sin esperar a que avance la época.
      */
     ~ListaSensor();
 
@@ -52,6 +155,18 @@ public:
      */
     void insertar(const T &valor);
 
+    /**
+     * @brief Inserta un lote de elementos al final de la lista
+     *
+     * Reserva los nodos de una sola vez, los enlaza en orden y actualiza
+     * las estadísticas en la misma pasada; emite una sola línea de log.
+     * Los lectores ven el lote completo o nada de él.
+     *
+     * @param valores Arreglo de valores en orden de llegada
+     * @param cantidad Número de valores del arreglo
+     */
+    void insertarLote(const T *valores, int cantidad);
+
     /**
      * @brief Busca un elemento en la lista
      * @param valor Valor a buscar
@@ -66,6 +181,31 @@ public:
      */
     bool eliminar(const T &valor);
 
+    /**
+     * @brief Cuenta las lecturas con un valor
+     * @param valor Valor buscado
+     * @return Número de lecturas con ese valor
+     */
+    int contarOcurrencias(const T &valor) const;
+
+    /**
+     * @brief Habilita el índice de valores para buscar y eliminar
+     *
+     * Se construye con las lecturas actuales y a partir de ahí se mantiene
+     * al insertar, sellar y eliminar. Llamadas posteriores no tienen efecto.
+     *
+     * @param minimoDenso Primer valor del dominio de conteo denso (solo T entero)
+     * @param maximoDenso Último valor del dominio denso (menor que minimoDenso =
+     *        todos los valores en el arreglo ordenado)
+     */
+    void habilitarIndice(long long minimoDenso = 0, long long maximoDenso = -1);
+
+    /**
+     * @brief Indica si el índice de valores está habilitado
+     * @return true si la lista mantiene un índice de valores
+     */
+    bool tieneIndice() const;
+
     /**
      * @brief Obtiene el numero de elementos en la lista
      * @return Numero de elementos
@@ -84,6 +224,24 @@ public:
      */
     T calcularPromedio() const;
 
+    /**
+     * @brief Obtiene los estimadores en flujo de las lecturas insertadas
+     *
+     * Cubren todas las lecturas que pasaron por insertar(), incluso las que
+     * después fueron eliminadas de la lista, y usan memoria acotada. Solo
+     * debe usarse desde el hilo escritor; los lectores concurrentes usan
+     * obtenerInstantaneaEstadisticas().
+     *
+     * @return Referencia constante a las estadísticas
+     */
+    const EstadisticaFlujo &obtenerEstadisticas() const;
+
+    /**
+     * @brief Copia coherente de los estimadores publicados
+     * @return Estimadores a la fecha de la última operación del escritor
+     */
+    EstadisticaFlujo obtenerInstantaneaEstadisticas() const;
+
     /**
      * @brief Encuentra y elimina el valor mínimo de la lista
      * @return El valor mínimo eliminado (valor por defecto si la lista está vacía)
@@ -96,30 +254,161 @@ public:
     void imprimir() const;
 
     /**
-     * @brief Libera toda la memoria de la lista
+     * @brief Recorre una instantánea coherente de la lista en orden de llegada
+     *
+     * Puede llamarse desde cualquier hilo; el escritor no se detiene mientras
+     * dura el recorrido.
+     *
+     * @tparam P Función invocable con (int) que recibe el número de lecturas
+     * @tparam F Función invocable con (const T&)
+     * @param preparar Se invoca una vez, antes de la primera lectura
+     * @param visitar Se invoca con cada lectura de la instantánea
+     */
+    template <typename P, typename F>
+    void recorrerInstantanea(P preparar, F visitar) const;
+
+    /**
+     * @brief Vacía la lista
+     *
+     * Publica la lista vacía y retira sus bloques y nodos como hace
+     * eliminar; se liberan cuando salen los lectores que aún recorren la
+     * versión anterior, sin que el escritor los espere.
      */
     void limpiar();
 
+    /**
+     * @brief Habilita el almacenamiento comprimido del historial
+     *
+     * A partir de este momento, cada vez que la cola activa acumula
+     * lecturasPorBloque nodos se sellan en un bloque codificado (XOR de
+     * Gorilla para flotantes, delta de deltas para enteros).
+     *
+     * @param lecturasPorBloque Lecturas por bloque sellado (2..MAX_LECTURAS_BLOQUE);
+     *        0 deshabilita el sellado de nuevos bloques
+     */
+    void habilitarCompresion(int lecturasPorBloque = 256);
+
+    /**
+     * @brief Obtiene el tamaño de bloque configurado
+     * @return Lecturas por bloque, o 0 si la compresión está deshabilitada
+     */
+    int obtenerLecturasPorBloque() const;
+
+    /**
+     * @brief Reserva de antemano los nodos para las próximas lecturas
+     *
+     * Con compresión la cola activa nunca supera lecturasPorBloque nodos,
+     * así que la reserva se limita a ese tamaño.
+     *
+     * @param lecturas Lecturas que se espera recibir
+     */
+    void reservarLecturas(int lecturas);
+
+    /**
+     * @brief Estima la memoria que ocupan las lecturas de la lista
+     * @return Bytes ocupados por nodos, bloques e índice (sin contar el objeto lista)
+     */
+    std::size_t memoriaResidente() const;
+
 private:
     /**
      * @brief Copia los elementos de otra lista
      * @param otra Lista a copiar
      */
     void copiar(const ListaSensor<T> &otra);
+
+    /**
+     * @brief Codifica la cola activa en un bloque nuevo y retira sus nodos
+     */
+    void sellar();
+
+    /**
+     * @brief Sustituye un bloque de la cadena copiando los bloques que lo preceden
+     * @param bloque Bloque a sustituir
+     * @param reemplazo Bloque que ocupa su lugar (nullptr para quitarlo)
+     */
+    void reemplazarBloque(BloqueHistorial<T> *bloque, BloqueHistorial<T> *reemplazo);
+
+    /**
+     * @brief Enlaza un nodo nuevo al final de la cola activa
+     * @param valor Valor del nodo
+     */
+    void enlazarAlFinal(const T &valor);
+
+    /**
+     * @brief Publica la cabecera y los estimadores actuales para los lectores
+     *
+     * Asigna época a los objetos retirados durante la operación y libera los
+     * que ya no pueden estar siendo leídos.
+     */
+    void publicar();
+
+    /**
+     * @brief Obtiene una copia coherente de la cabecera publicada
+     * @return Cabecera vigente
+     */
+    Cabecera leerCabecera() const;
+
+    /**
+     * @brief Retira un objeto desenlazado de la vista del escritor
+     * @param objeto Nodo o bloque retirado
+     * @param clase Clase del objeto
+     */
+    void retirar(void *objeto, Retirado clase);
+
+    /**
+     * @brief Libera los objetos retirados que ningún lector puede alcanzar
+     * @param todos true para liberar todos (tras un período de gracia)
+     */
+    void recolectar(bool todos);
+
+    /**
+     * @brief Copia el digesto actual en un objeto que ningún lector alcanza
+     * @return Digesto nuevo (reutilizado de digestosLibres si hay alguno)
+     */
+    DigestoCuantiles *copiarDigesto();
+
+    /**
+     * @brief Recorre todas las lecturas de una instantánea en orden de llegada
+     *
+     * Debe llamarse dentro de una GuardiaEpoca.
+     *
+     * @tparam F Función invocable con (const T&)
+     * @param vista Cabecera de la instantánea
+     * @param visitar Función a aplicar a cada lectura
+     */
+    template <typename F>
+    static void recorrer(const Cabecera &vista, F visitar);
 };
 
 // Implementación de métodos template
 
 template <typename T>
-ListaSensor<T>::ListaSensor() : cabeza(nullptr), tamano(0)
+ListaSensor<T>::ListaSensor() : cabeza(nullptr), cola(nullptr), tamano(0), numNodos(0), primerBloque(nullptr),
+                                ultimoBloque(nullptr), numBloques(0), lecturasPorBloque(0), estadisticasCambiadas(false),
+                                indice(nullptr), secuencia(0), publicada(), numDigestosLibres(0), retirados(nullptr),
+                                numRetirados(0), capacidadRetirados(0), retiradosSinEpoca(0)
 {
     std::cout << "[Log] ListaSensor<T> creada." << std::endl;
 }
 
 template <typename T>
-ListaSensor<T>::ListaSensor(const ListaSensor<T> &otra) : cabeza(nullptr), tamano(0)
+ListaSensor<T>::ListaSensor(const ListaSensor<T> &otra) : cabeza(nullptr), cola(nullptr), tamano(0), numNodos(0),
+                                                          primerBloque(nullptr), ultimoBloque(nullptr), numBloques(0),
+                                                          lecturasPorBloque(otra.obtenerLecturasPorBloque()),
+                                                          estadisticasCambiadas(false), indice(nullptr), secuencia(0),
+                                                          publicada(), numDigestosLibres(0), retirados(nullptr),
+                                                          numRetirados(0), capacidadRetirados(0), retiradosSinEpoca(0)
 {
+    IndiceValores<T> *indiceOtra = otra.indice.load(std::memory_order_acquire);
+    if (indiceOtra != nullptr)
+    {
+        habilitarIndice(indiceOtra->obtenerMinimoDenso(), indiceOtra->obtenerMaximoDenso());
+    }
     copiar(otra);
+    estadisticas = otra.obtenerInstantaneaEstadisticas();
+    estadisticasCambiadas = true;
+    publicar();
 }
 
 template <typename T>
@@ -128,7 +417,16 @@ ListaSensor<T> &ListaSensor<T>::operator=(const ListaSensor<T> &otra)
     if (this != &otra)
     {
         limpiar();
+        lecturasPorBloque = otra.obtenerLecturasPorBloque();
+        IndiceValores<T> *indiceOtra = otra.indice.load(std::memory_order_acquire);
+        if (indiceOtra != nullptr)
+        {
+            habilitarIndice(indiceOtra->obtenerMinimoDenso(), indiceOtra->obtenerMaximoDenso());
+        }
         copiar(otra);
+        estadisticas = otra.obtenerInstantaneaEstadisticas();
+        estadisticasCambiadas = true;
+        publicar();
     }
     return *this;
 }
@@ -137,43 +435,113 @@ template <typename T>
 ListaSensor<T>::~ListaSensor()
 {
     limpiar();
+    recolectar(true);
+    delete publicada.digesto;
+    for (int i = 0; i < numDigestosLibres; i++)
+    {
+        delete digestosLibres[i];
+    }
+    delete[] retirados;
+    delete indice.load();
     std::cout << "[Log] ListaSensor<T> destruida." << std::endl;
 }
 
 template <typename T>
 void ListaSensor<T>::insertar(const T &valor)
 {
-    Nodo<T> *nuevoNodo = new Nodo<T>(valor);
+    enlazarAlFinal(valor);
+    estadisticas.agregar(static_cast<double>(valor));
+    estadisticasCambiadas = true;
+    std::cout << "[Log] Insertando Nodo<T> con valor: " << valor << std::endl;
 
-    if (cabeza == nullptr)
+    if (lecturasPorBloque > 0 && numNodos >= lecturasPorBloque)
     {
-        cabeza = nuevoNodo;
+        sellar();
     }
-    else
+    publicar();
+}
+
+template <typename T>
+void ListaSensor<T>::insertarLote(const T *valores, int cantidad)
+{
+    if (cantidad <= 0)
+    {
+        return;
+    }
+
+    // Con compresión, los nodos sellados vuelven al pool y basta un bloque de espacio
+    int porReservar = cantidad;
+    if (lecturasPorBloque > 0 && porReservar > lecturasPorBloque)
+    {
+        porReservar = lecturasPorBloque;
+    }
+    pool.reservar(porReservar);
+
+    estadisticasCambiadas = true;
+    for (int i = 0; i < cantidad; i++)
     {
-        Nodo<T> *actual = cabeza;
-        while (actual->siguiente != nullptr)
+        enlazarAlFinal(valores[i]);
+        estadisticas.agregar(static_cast<double>(valores[i]));
+
+        if (lecturasPorBloque > 0 && numNodos >= lecturasPorBloque)
         {
-            actual = actual->siguiente;
+            sellar();
         }
-        actual->siguiente = nuevoNodo;
     }
-
-    tamano++;
-    std::cout << "[Log] Insertando Nodo<T> con valor: " << valor << std::endl;
+    publicar();
+    std::cout << "[Log] Insertando lote de " << cantidad << " Nodo<T>." << std::endl;
 }
 
 template <typename T>
 bool ListaSensor<T>::buscar(const T &valor) const
 {
-    Nodo<T> *actual = cabeza;
-    while (actual != nullptr)
+    IndiceValores<T> *indiceValores = indice.load(std::memory_order_acquire);
+    if (indiceValores != nullptr)
+    {
+        int ocurrencias = indiceValores->contar(valor);
+        if (ocurrencias >= 0)
+        {
+            return ocurrencias > 0;
+        }
+    }
+
+    GuardiaEpoca guardia;
+    Cabecera vista = leerCabecera();
+
+    T valores[MAX_LECTURAS_BLOQUE];
+    BloqueHistorial<T> *bloque = vista.primerBloque;
+    for (int b = 0; b < vista.numBloques; b++)
     {
+        if (b > 0)
+        {
+            bloque = bloque->siguiente;
+        }
+        // Descartar el bloque completo si el valor queda fuera de su rango
+        if (valor < bloque->minimo || bloque->maximo < valor)
+        {
+            continue;
+        }
+        bloque->decodificar(valores);
+        for (int i = 0; i < bloque->cantidad; i++)
+        {
+            if (valores[i] == valor)
+            {
+                return true;
+            }
+        }
+    }
+
+    Nodo<T> *actual = vista.cabeza;
+    for (int n = 0; n < vista.numNodos; n++)
+    {
+        if (n > 0)
+        {
+            actual = actual->siguiente;
+        }
         if (actual->dato == valor)
         {
             return true;
         }
-        actual = actual->siguiente;
     }
     return false;
 }
@@ -181,87 +549,260 @@ bool ListaSensor<T>::buscar(const T &valor) const
 template <typename T>
 bool ListaSensor<T>::eliminar(const T &valor)
 {
-    if (cabeza == nullptr)
+    // Con índice, un valor ausente o solo presente en nodos no decodifica bloques
+    IndiceValores<T> *indiceValores = indice.load(std::memory_order_relaxed);
+    BloqueHistorial<T> *primero = primerBloque;
+    if (indiceValores != nullptr)
+    {
+        if (indiceValores->contar(valor) == 0)
+        {
+            return false;
+        }
+        if (indiceValores->contarEnBloques(valor) == 0)
+        {
+            primero = nullptr;
+        }
+    }
+
+    // Las lecturas más antiguas están en los bloques sellados
+    T valores[MAX_LECTURAS_BLOQUE];
+    for (BloqueHistorial<T> *bloque = primero; bloque != nullptr; bloque = bloque->siguiente)
+    {
+        if (valor < bloque->minimo || bloque->maximo < valor)
+        {
+            continue;
+        }
+        bloque->decodificar(valores);
+        for (int i = 0; i < bloque->cantidad; i++)
+        {
+            if (valores[i] == valor)
+            {
+                for (int j = i + 1; j < bloque->cantidad; j++)
+                {
+                    valores[j - 1] = valores[j];
+                }
+                // El bloque publicado no se modifica: se sustituye por uno nuevo
+                BloqueHistorial<T> *reemplazo = nullptr;
+                if (bloque->cantidad > 1)
+                {
+                    reemplazo = new BloqueHistorial<T>(valores, bloque->cantidad - 1);
+                }
+                reemplazarBloque(bloque, reemplazo);
+                tamano--;
+                if (indiceValores != nullptr)
+                {
+                    indiceValores->quitar(valor, true);
+                }
+                publicar();
+                std::cout << "[Log] Lectura " << valor << " eliminada de Bloque<T>." << std::endl;
+                return true;
+            }
+        }
+    }
+
+    Nodo<T> *objetivo = cabeza;
+    while (objetivo != nullptr && objetivo->dato != valor)
+    {
+        objetivo = objetivo->siguiente;
+    }
+    if (objetivo == nullptr)
     {
         return false;
     }
 
-    if (cabeza->dato == valor)
+    // Copiar el tramo anterior al nodo: los nodos publicados no se modifican
+    Nodo<T> *nuevaCabeza = objetivo->siguiente;
+    Nodo<T> *ultimaCopia = nullptr;
+    for (Nodo<T> *actual = cabeza; actual != objetivo; actual = actual->siguiente)
     {
-        Nodo<T> *temp = cabeza;
-        cabeza = cabeza->siguiente;
-        delete temp;
-        tamano--;
-        std::cout << "[Log] Nodo<T> " << valor << " liberado." << std::endl;
-        return true;
+        Nodo<T> *copia = pool.crear(actual->dato);
+        if (ultimaCopia == nullptr)
+        {
+            nuevaCabeza = copia;
+        }
+        else
+        {
+            ultimaCopia->siguiente = copia;
+        }
+        ultimaCopia = copia;
+        retirar(actual, Retirado::NODO);
     }
+    if (ultimaCopia != nullptr)
+    {
+        ultimaCopia->siguiente = objetivo->siguiente;
+    }
+    if (objetivo == cola)
+    {
+        cola = ultimaCopia;
+    }
+    cabeza = nuevaCabeza;
+    retirar(objetivo, Retirado::NODO);
 
-    Nodo<T> *actual = cabeza;
-    while (actual->siguiente != nullptr && actual->siguiente->dato != valor)
+    tamano--;
+    numNodos--;
+    if (indiceValores != nullptr)
     {
-        actual = actual->siguiente;
+        indiceValores->quitar(valor, false);
     }
+    publicar();
+    std::cout << "[Log] Nodo<T> " << valor << " liberado." << std::endl;
+    return true;
+}
 
-    if (actual->siguiente != nullptr)
+template <typename T>
+int ListaSensor<T>::contarOcurrencias(const T &valor) const
+{
+    IndiceValores<T> *indiceValores = indice.load(std::memory_order_acquire);
+    if (indiceValores != nullptr)
     {
-        Nodo<T> *temp = actual->siguiente;
-        actual->siguiente = temp->siguiente;
-        delete temp;
-        tamano--;
-        std::cout << "[Log] Nodo<T> " << valor << " liberado." << std::endl;
-        return true;
+        int ocurrencias = indiceValores->contar(valor);
+        if (ocurrencias >= 0)
+        {
+            return ocurrencias;
+        }
     }
 
-    return false;
+    int ocurrencias = 0;
+    recorrerInstantanea([](int) {}, [&ocurrencias, &valor](const T &dato)
+                        { ocurrencias += dato == valor ? 1 : 0; });
+    return ocurrencias;
+}
+
+template <typename T>
+void ListaSensor<T>::habilitarIndice(long long minimoDenso, long long maximoDenso)
+{
+    if (indice.load(std::memory_order_relaxed) != nullptr)
+    {
+        return;
+    }
+
+    IndiceValores<T> *nuevo = new IndiceValores<T>();
+    nuevo->configurarDominio(minimoDenso, maximoDenso);
+
+    T valores[MAX_LECTURAS_BLOQUE];
+    for (BloqueHistorial<T> *bloque = primerBloque; bloque != nullptr; bloque = bloque->siguiente)
+    {
+        bloque->decodificar(valores);
+        for (int i = 0; i < bloque->cantidad; i++)
+        {
+            nuevo->agregar(valores[i], true);
+        }
+    }
+    for (Nodo<T> *actual = cabeza; actual != nullptr; actual = actual->siguiente)
+    {
+        nuevo->agregar(actual->dato, false);
+    }
+
+    indice.store(nuevo, std::memory_order_release);
+}
+
+template <typename T>
+bool ListaSensor<T>::tieneIndice() const
+{
+    return indice.load(std::memory_order_acquire) != nullptr;
 }
 
 template <typename T>
 int ListaSensor<T>::obtenerTamano() const
 {
-    return tamano;
+    return leerCabecera().tamano;
 }
 
 template <typename T>
 bool ListaSensor<T>::estaVacia() const
 {
-    return cabeza == nullptr;
+    return obtenerTamano() == 0;
 }
 
 template <typename T>
 T ListaSensor<T>::calcularPromedio() const
 {
-    if (estaVacia())
+    GuardiaEpoca guardia;
+    Cabecera vista = leerCabecera();
+    if (vista.tamano == 0)
     {
         return T{};
     }
 
-    T suma = T{};
-    Nodo<T> *actual = cabeza;
-    while (actual != nullptr)
+    // Los bloques sellados aportan su suma precalculada sin decodificarse
+    double suma = 0.0;
+    BloqueHistorial<T> *bloque = vista.primerBloque;
+    for (int b = 0; b < vista.numBloques; b++)
     {
-        suma += actual->dato;
-        actual = actual->siguiente;
+        if (b > 0)
+        {
+            bloque = bloque->siguiente;
+        }
+        suma += bloque->suma;
     }
 
-    return suma / static_cast<T>(tamano);
+    Nodo<T> *actual = vista.cabeza;
+    for (int n = 0; n < vista.numNodos; n++)
+    {
+        if (n > 0)
+        {
+            actual = actual->siguiente;
+        }
+        suma += static_cast<double>(actual->dato);
+    }
+
+    return static_cast<T>(suma / vista.tamano);
+}
+
+template <typename T>
+const EstadisticaFlujo &ListaSensor<T>::obtenerEstadisticas() const
+{
+    return estadisticas;
+}
+
+template <typename T>
+EstadisticaFlujo ListaSensor<T>::obtenerInstantaneaEstadisticas() const
+{
+    // El digesto que alcanza la cabecera no cambia ni se libera mientras dure la guardia
+    GuardiaEpoca guardia;
+    Cabecera vista = leerCabecera();
+    if (vista.digesto == nullptr)
+    {
+        return EstadisticaFlujo(vista.varianza, DigestoCuantiles());
+    }
+    return EstadisticaFlujo(vista.varianza, *vista.digesto);
 }
 
 template <typename T>
 T ListaSensor<T>::eliminarMinimo()
 {
-    if (estaVacia())
+    if (tamano == 0)
     {
         return T{};
     }
 
-    // Encontrar el valor mínimo
-    T minimo = cabeza->dato;
-    Nodo<T> *actual = cabeza->siguiente;
+    // El índice conoce el mínimo sin recorrer la lista
+    T minimo = T{};
+    IndiceValores<T> *indiceValores = indice.load(std::memory_order_relaxed);
+    if (indiceValores != nullptr && indiceValores->minimo(minimo))
+    {
+        eliminar(minimo);
+        return minimo;
+    }
+
+    // Encontrar el valor mínimo (los bloques aportan su mínimo precalculado)
+    bool hayMinimo = false;
+    for (BloqueHistorial<T> *bloque = primerBloque; bloque != nullptr; bloque = bloque->siguiente)
+    {
+        if (!hayMinimo || bloque->minimo < minimo)
+        {
+            minimo = bloque->minimo;
+            hayMinimo = true;
+        }
+    }
+
+    Nodo<T> *actual = cabeza;
     while (actual != nullptr)
     {
-        if (actual->dato < minimo)
+        if (!hayMinimo || actual->dato < minimo)
         {
             minimo = actual->dato;
+            hayMinimo = true;
         }
         actual = actual->siguiente;
     }
@@ -274,37 +815,403 @@ T ListaSensor<T>::eliminarMinimo()
 template <typename T>
 void ListaSensor<T>::imprimir() const
 {
+    GuardiaEpoca guardia;
     std::cout << "Lista: ";
-    Nodo<T> *actual = cabeza;
-    while (actual != nullptr)
-    {
-        std::cout << actual->dato << " ";
-        actual = actual->siguiente;
-    }
+    recorrer(leerCabecera(), [](const T &valor)
+             { std::cout << valor << " "; });
     std::cout << std::endl;
 }
 
+template <typename T>
+template <typename P, typename F>
+void ListaSensor<T>::recorrerInstantanea(P preparar, F visitar) const
+{
+    GuardiaEpoca guardia;
+    Cabecera vista = leerCabecera();
+    preparar(vista.tamano);
+    recorrer(vista, visitar);
+}
+
 template <typename T>
 void ListaSensor<T>::limpiar()
 {
-    while (cabeza != nullptr)
+    BloqueHistorial<T> *bloques = primerBloque;
+    Nodo<T> *nodos = cabeza;
+
+    primerBloque = nullptr;
+    ultimoBloque = nullptr;
+    numBloques = 0;
+    cabeza = nullptr;
+    cola = nullptr;
+    tamano = 0;
+    numNodos = 0;
+    IndiceValores<T> *indiceValores = indice.load(std::memory_order_relaxed);
+    if (indiceValores != nullptr)
     {
-        Nodo<T> *temp = cabeza;
-        cabeza = cabeza->siguiente;
+        indiceValores->limpiar();
+    }
+
+    while (bloques != nullptr)
+    {
+        BloqueHistorial<T> *temp = bloques;
+        bloques = bloques->siguiente;
+        std::cout << "[Log] Bloque<T> de " << temp->cantidad << " lecturas liberado." << std::endl;
+        retirar(temp, Retirado::BLOQUE);
+    }
+
+    while (nodos != nullptr)
+    {
+        Nodo<T> *temp = nodos;
+        nodos = nodos->siguiente;
         std::cout << "[Log] Nodo<T> " << temp->dato << " liberado." << std::endl;
-        delete temp;
+        retirar(temp, Retirado::NODO);
     }
-    tamano = 0;
+    publicar();
+}
+
+template <typename T>
+void ListaSensor<T>::habilitarCompresion(int lecturasPorBloque)
+{
+    if (lecturasPorBloque > MAX_LECTURAS_BLOQUE)
+    {
+        lecturasPorBloque = MAX_LECTURAS_BLOQUE;
+    }
+    if (lecturasPorBloque == 1)
+    {
+        lecturasPorBloque = 2;
+    }
+    this->lecturasPorBloque = lecturasPorBloque > 0 ? lecturasPorBloque : 0;
+
+    while (this->lecturasPorBloque > 0 && numNodos >= this->lecturasPorBloque)
+    {
+        sellar();
+    }
+    publicar();
+}
+
+template <typename T>
+int ListaSensor<T>::obtenerLecturasPorBloque() const
+{
+    return leerCabecera().lecturasPorBloque;
+}
+
+template <typename T>
+void ListaSensor<T>::reservarLecturas(int lecturas)
+{
+    if (lecturasPorBloque > 0 && lecturas > lecturasPorBloque - numNodos)
+    {
+        lecturas = lecturasPorBloque - numNodos;
+    }
+    if (lecturas > 0)
+    {
+        pool.reservar(lecturas);
+    }
+}
+
+template <typename T>
+std::size_t ListaSensor<T>::memoriaResidente() const
+{
+    GuardiaEpoca guardia;
+    Cabecera vista = leerCabecera();
+
+    std::size_t bytes = vista.bytesNodos;
+    IndiceValores<T> *indiceValores = indice.load(std::memory_order_acquire);
+    if (indiceValores != nullptr)
+    {
+        bytes += indiceValores->memoria();
+    }
+    BloqueHistorial<T> *bloque = vista.primerBloque;
+    for (int b = 0; b < vista.numBloques; b++)
+    {
+        if (b > 0)
+        {
+            bloque = bloque->siguiente;
+        }
+        bytes += sizeof(BloqueHistorial<T>) + static_cast<std::size_t>(bloque->bytes);
+    }
+    return bytes;
 }
 
 template <typename T>
 void ListaSensor<T>::copiar(const ListaSensor<T> &otra)
 {
-    Nodo<T> *actual = otra.cabeza;
-    while (actual != nullptr)
+    GuardiaEpoca guardia;
+    recorrer(otra.leerCabecera(), [this](const T &valor)
+             { insertar(valor); });
+}
+
+template <typename T>
+void ListaSensor<T>::sellar()
+{
+    T valores[MAX_LECTURAS_BLOQUE];
+    int n = 0;
+
+    // Tomar las lecturas más antiguas de la cola activa
+    while (cabeza != nullptr && n < lecturasPorBloque)
     {
-        insertar(actual->dato);
-        actual = actual->siguiente;
+        Nodo<T> *temp = cabeza;
+        valores[n++] = temp->dato;
+        cabeza = cabeza->siguiente;
+        retirar(temp, Retirado::NODO);
+    }
+
+    IndiceValores<T> *indiceValores = indice.load(std::memory_order_relaxed);
+    for (int i = 0; indiceValores != nullptr && i < n; i++)
+    {
+        indiceValores->sellar(valores[i]);
+    }
+    if (cabeza == nullptr)
+    {
+        cola = nullptr;
+    }
+    numNodos -= n;
+
+    BloqueHistorial<T> *bloque = new BloqueHistorial<T>(valores, n);
+    if (ultimoBloque == nullptr)
+    {
+        primerBloque = bloque;
+    }
+    else
+    {
+        ultimoBloque->siguiente = bloque;
+    }
+    ultimoBloque = bloque;
+    numBloques++;
+
+    std::cout << "[Log] Bloque<T> sellado: " << n << " lecturas en " << bloque->bytes << " bytes." << std::endl;
+}
+
+template <typename T>
+void ListaSensor<T>::enlazarAlFinal(const T &valor)
+{
+    Nodo<T> *nuevoNodo = pool.crear(valor);
+
+    if (cola == nullptr)
+    {
+        cabeza = nuevoNodo;
+    }
+    else
+    {
+        cola->siguiente = nuevoNodo;
+    }
+    cola = nuevoNodo;
+
+    tamano++;
+    numNodos++;
+
+    IndiceValores<T> *indiceValores = indice.load(std::memory_order_relaxed);
+    if (indiceValores != nullptr)
+    {
+        indiceValores->agregar(valor, false);
+    }
+}
+
+template <typename T>
+void ListaSensor<T>::reemplazarBloque(BloqueHistorial<T> *bloque, BloqueHistorial<T> *reemplazo)
+{
+    BloqueHistorial<T> *nuevoPrimero = nullptr;
+    BloqueHistorial<T> *ultimaCopia = nullptr;
+    for (BloqueHistorial<T> *actual = primerBloque; actual != bloque; actual = actual->siguiente)
+    {
+        BloqueHistorial<T> *copia = actual->clonar();
+        if (ultimaCopia == nullptr)
+        {
+            nuevoPrimero = copia;
+        }
+        else
+        {
+            ultimaCopia->siguiente = copia;
+        }
+        ultimaCopia = copia;
+        retirar(actual, Retirado::BLOQUE);
+    }
+
+    BloqueHistorial<T> *resto = bloque->siguiente;
+    if (reemplazo != nullptr)
+    {
+        reemplazo->siguiente = resto;
+        resto = reemplazo;
+    }
+    else
+    {
+        numBloques--;
+    }
+
+    if (ultimaCopia == nullptr)
+    {
+        nuevoPrimero = resto;
+    }
+    else
+    {
+        ultimaCopia->siguiente = resto;
+    }
+    if (ultimoBloque == bloque)
+    {
+        ultimoBloque = reemplazo != nullptr ? reemplazo : ultimaCopia;
+    }
+    primerBloque = nuevoPrimero;
+    retirar(bloque, Retirado::BLOQUE);
+}
+
+template <typename T>
+void ListaSensor<T>::publicar()
+{
+    const DigestoCuantiles *digesto = publicada.digesto;
+    if (estadisticasCambiadas)
+    {
+        if (digesto != nullptr)
+        {
+            retirar(const_cast<DigestoCuantiles *>(digesto), Retirado::DIGESTO);
+        }
+        digesto = estadisticas.obtenerCantidad() > 0 ? copiarDigesto() : nullptr;
+        estadisticasCambiadas = false;
+    }
+
+    unsigned int actual = secuencia.load(std::memory_order_relaxed);
+    secuencia.store(actual + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    publicada.primerBloque = primerBloque;
+    publicada.numBloques = numBloques;
+    publicada.cabeza = cabeza;
+    publicada.numNodos = numNodos;
+    publicada.tamano = tamano;
+    publicada.lecturasPorBloque = lecturasPorBloque;
+    publicada.bytesNodos = pool.bytesReservados();
+    publicada.varianza = estadisticas.obtenerEstimadorVarianza();
+    publicada.digesto = digesto;
+
+    secuencia.store(actual + 2, std::memory_order_release);
+
+    // Lo retirado en esta operación deja de ser alcanzable para lectores nuevos
+    if (retiradosSinEpoca < numRetirados)
+    {
+        std::uint64_t epoca = GestorEpocas::global().epocaActual();
+        for (int i = retiradosSinEpoca; i < numRetirados; i++)
+        {
+            retirados[i].epoca = epoca;
+        }
+        retiradosSinEpoca = numRetirados;
+    }
+    if (numRetirados > 0)
+    {
+        recolectar(false);
+    }
+}
+
+template <typename T>
+typename ListaSensor<T>::Cabecera ListaSensor<T>::leerCabecera() const
+{
+    Cabecera vista;
+    unsigned int antes;
+    unsigned int despues;
+    do
+    {
+        antes = secuencia.load(std::memory_order_acquire);
+        std::memcpy(&vista, &publicada, sizeof(vista));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        despues = secuencia.load(std::memory_order_relaxed);
+    } while ((antes & 1u) != 0 || antes != despues);
+    return vista;
+}
+
+template <typename T>
+void ListaSensor<T>::retirar(void *objeto, Retirado clase)
+{
+    if (numRetirados == capacidadRetirados)
+    {
+        int nuevaCapacidad = capacidadRetirados > 0 ? capacidadRetirados * 2 : 16;
+        Retiro *nuevos = new Retiro[nuevaCapacidad];
+        for (int i = 0; i < numRetirados; i++)
+        {
+            nuevos[i] = retirados[i];
+        }
+        delete[] retirados;
+        retirados = nuevos;
+        capacidadRetirados = nuevaCapacidad;
+    }
+    retirados[numRetirados].objeto = objeto;
+    retirados[numRetirados].clase = clase;
+    retirados[numRetirados].epoca = 0;
+    numRetirados++;
+}
+
+template <typename T>
+void ListaSensor<T>::recolectar(bool todos)
+{
+    std::uint64_t epoca = GestorEpocas::global().intentarAvanzar();
+    int liberados = 0;
+    while (liberados < retiradosSinEpoca && (todos || retirados[liberados].epoca + 2 <= epoca))
+    {
+        void *objeto = retirados[liberados].objeto;
+        switch (retirados[liberados].clase)
+        {
+        case Retirado::NODO:
+            pool.liberar(static_cast<Nodo<T> *>(objeto));
+            break;
+        case Retirado::BLOQUE:
+            delete static_cast<BloqueHistorial<T> *>(objeto);
+            break;
+        case Retirado::DIGESTO:
+            if (numDigestosLibres < MAX_DIGESTOS_LIBRES)
+            {
+                digestosLibres[numDigestosLibres++] = static_cast<DigestoCuantiles *>(objeto);
+            }
+            else
+            {
+                delete static_cast<DigestoCuantiles *>(objeto);
+            }
+            break;
+        }
+        liberados++;
+    }
+
+    if (liberados > 0)
+    {
+        for (int i = liberados; i < numRetirados; i++)
+        {
+            retirados[i - liberados] = retirados[i];
+        }
+        numRetirados -= liberados;
+        retiradosSinEpoca -= liberados;
+    }
+}
+
+template <typename T>
+DigestoCuantiles *ListaSensor<T>::copiarDigesto()
+{
+    DigestoCuantiles *digesto = numDigestosLibres > 0 ? digestosLibres[--numDigestosLibres] : new DigestoCuantiles();
+    *digesto = estadisticas.obtenerDigesto();
+    return digesto;
+}
+
+template <typename T>
+template <typename F>
+void ListaSensor<T>::recorrer(const Cabecera &vista, F visitar)
+{
+    T valores[MAX_LECTURAS_BLOQUE];
+    BloqueHistorial<T> *bloque = vista.primerBloque;
+    for (int b = 0; b < vista.numBloques; b++)
+    {
+        if (b > 0)
+        {
+            bloque = bloque->siguiente;
+        }
+        bloque->decodificar(valores);
+        for (int i = 0; i < bloque->cantidad; i++)
+        {
+            visitar(valores[i]);
+        }
+    }
+
+    Nodo<T> *actual = vista.cabeza;
+    for (int n = 0; n < vista.numNodos; n++)
+    {
+        if (n > 0)
+        {
+            actual = actual->siguiente;
+        }
+        visitar(actual->dato);
     }
 }
 
@@ -0,0 +1,172 @@
+/**
+ * @file MemoriaHistorial.h
+ * @brief Respaldo de memoria para historiales: páginas grandes y afinidad NUMA
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef MEMORIA_HISTORIAL_H
+#define MEMORIA_HISTORIAL_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+
+/**
+ * @brief Contadores del respaldo de memoria de historiales
+ */
+struct EstadisticasMemoria {
+    unsigned long long reservasLocales;     ///< Losas reservadas desde el nodo del hilo que las pidió
+    unsigned long long reservasRemotas;     ///< Losas reservadas en el nodo de la lista, distinto del hilo
+    unsigned long long regionesGrandes;     ///< Regiones respaldadas por páginas de 2 MB (MAP_HUGETLB)
+    unsigned long long regionesAconsejadas; ///< Regiones con páginas grandes transparentes (madvise)
+    unsigned long long regionesNormales;    ///< Regiones con páginas normales
+    unsigned long long enlacesFallidos;     ///< Regiones que no pudieron fijarse a su nodo
+    unsigned long long bytesRegiones;       ///< Bytes mapeados en total
+};
+
+/**
+ * @brief Asignador de losas para los historiales de sensores
+ *
+ * Cuando está habilitado, las losas de PoolNodos se toman de regiones de
+ * 2 MB alineadas, una arena por nodo NUMA. Cada región se pide primero con
+ * MAP_HUGETLB; si el sistema no tiene páginas grandes reservadas se mapea
+ * normal y se aconseja MADV_HUGEPAGE, y si eso tampoco está disponible se
+ * usa tal cual. Con más de un nodo, cada región se fija (mbind) al nodo de
+ * su arena, así que no depende de qué hilo la toque primero.
+ *
+ * Cada lista queda asociada al nodo del hilo que reservó su primera losa (el
+ * hilo de ingesta de su fragmento de la flota); sus losas siguientes salen
+ * de ese mismo nodo aunque las pida otro hilo, y los contadores distinguen
+ * las reservas locales de las remotas.
+ *
+ * Las losas se redondean a potencias de 2 y las liberadas se reutilizan
+ * dentro de su nodo; las regiones no se devuelven al sistema. Fuera de Linux
+ * el respaldo recurre a operator new.
+ */
+class MemoriaHistorial {
+public:
+    static const std::size_t TAM_REGION = 2u << 20;  ///< Tamaño de región (una página grande)
+    static const int MAX_NODOS = 8;                  ///< Nodos NUMA atendidos
+
+private:
+    static const int MIN_CLASE = 8;   ///< Clase mínima: 256 bytes
+    static const int MAX_CLASE = 20;  ///< Clase máxima: 1 MiB (mayores: región propia)
+
+    /**
+     * @brief Losa liberada, enlazada en la lista de su clase
+     */
+    struct Libre {
+        Libre* siguiente;  ///< Siguiente losa libre de la misma clase
+    };
+
+    /**
+     * @brief Arena de un nodo NUMA
+     */
+    struct Arena {
+        std::mutex candado;                 ///< Protege la arena
+        unsigned char* actual;              ///< Región de la que se reparten losas
+        std::size_t usados;                 ///< Bytes repartidos de la región actual
+        Libre* libres[MAX_CLASE + 1];       ///< Losas liberadas por clase
+    };
+
+    std::atomic<bool> habilitado;           ///< Si PoolNodos debe usar el respaldo
+    bool paginasGrandes;                    ///< Si se intentan páginas de 2 MB
+    int numNodos;                           ///< Nodos NUMA con memoria
+    Arena arenas[MAX_NODOS];                ///< Una arena por nodo
+
+    std::atomic<unsigned long long> reservasLocales;
+    std::atomic<unsigned long long> reservasRemotas;
+    std::atomic<unsigned long long> regionesGrandes;
+    std::atomic<unsigned long long> regionesAconsejadas;
+    std::atomic<unsigned long long> regionesNormales;
+    std::atomic<unsigned long long> enlacesFallidos;
+    std::atomic<unsigned long long> bytesRegiones;
+
+public:
+    /**
+     * @brief Instancia compartida por todos los historiales del proceso
+     * @return Referencia al respaldo global
+     */
+    static MemoriaHistorial& global();
+
+    /**
+     * @brief Activa el respaldo para las losas que se reserven en adelante
+     * @param paginasGrandes Si se intentan páginas de 2 MB para las regiones
+     */
+    void habilitar(bool paginasGrandes);
+
+    /**
+     * @brief Indica si el respaldo está activo
+     * @return true si las losas nuevas deben pedirse con reservar()
+     */
+    bool estaHabilitado() const;
+
+    /**
+     * @brief Nodo NUMA de la CPU en la que corre el hilo que llama
+     * @return Índice de nodo (0..obtenerNumNodos()-1)
+     */
+    int nodoActual() const;
+
+    /**
+     * @brief Obtiene el número de nodos NUMA atendidos
+     * @return Nodos (1 en sistemas sin NUMA)
+     */
+    int obtenerNumNodos() const;
+
+    /**
+     * @brief Reserva una losa en el nodo indicado
+     * @param bytes Tamaño mínimo requerido
+     * @param nodo Nodo de la lista dueña de la losa
+     * @param bytesReales Recibe el tamaño realmente disponible (>= bytes)
+     * @return Memoria alineada a 64 bytes (nunca nullptr; lanza std::bad_alloc)
+     */
+    void* reservar(std::size_t bytes, int nodo, std::size_t& bytesReales);
+
+    /**
+     * @brief Devuelve una losa a la arena de su nodo
+     * @param memoria Losa obtenida con reservar()
+     * @param bytesReales Tamaño informado por reservar()
+     * @param nodo Nodo con el que se reservó
+     */
+    void liberar(void* memoria, std::size_t bytesReales, int nodo);
+
+    /**
+     * @brief Copia de los contadores
+     * @return Contadores actuales
+     */
+    EstadisticasMemoria obtenerEstadisticas() const;
+
+    /**
+     * @brief Imprime los contadores en una línea de registro
+     * @param salida Flujo destino
+     */
+    void imprimirEstadisticas(std::ostream& salida) const;
+
+private:
+    /**
+     * @brief Constructor - detecta los nodos NUMA (no reserva memoria)
+     */
+    MemoriaHistorial();
+
+    /**
+     * @brief Mapea una región alineada a 2 MB y la fija a un nodo
+     * @param bytes Tamaño (múltiplo de TAM_REGION)
+     * @param nodo Nodo destino
+     * @return Región mapeada, o nullptr si no hay memoria
+     */
+    unsigned char* mapearRegion(std::size_t bytes, int nodo);
+
+    /**
+     * @brief Clase (log2 del tamaño) de una losa
+     * @param bytes Tamaño requerido
+     * @return Clase entre MIN_CLASE y MAX_CLASE + 1 (región propia)
+     */
+    static int claseDe(std::size_t bytes);
+
+    MemoriaHistorial(const MemoriaHistorial&);             ///< No copiable
+    MemoriaHistorial& operator=(const MemoriaHistorial&);  ///< No asignable
+};
+
+#endif // MEMORIA_HISTORIAL_H
@@ -0,0 +1,182 @@
+/**
+ * @file MotorReglas.h
+ * @brief Motor incremental de reglas de umbral y alertas evaluado en la ingesta
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef MOTOR_REGLAS_H
+#define MOTOR_REGLAS_H
+
+#include "SensorBase.h"
+#include "ColaAlertas.h"
+
+/**
+ * @brief Comparación que aplica una regla sobre el valor observado
+ */
+enum class ComparadorRegla : unsigned char {
+    MAYOR_QUE,   ///< Valor observado > umbral
+    MENOR_QUE,   ///< Valor observado < umbral
+    VARIACION    ///< |lectura - lectura anterior| > umbral
+};
+
+/**
+ * @brief Forma compilada de una regla
+ *
+ * Sintaxis de la especificación textual:
+ * @code
+ * <objetivo> [promedio N] (> | < | variacion) <umbral> [durante S]
+ * @endcode
+ * donde el objetivo es el nombre de un sensor o `tipo:<clave>`, con la
+ * clave de rasgosTipoSensor() (`tipo:temperatura`, `tipo:presion`). Con `promedio N` se compara el promedio de las últimas N
+ * lecturas; con `durante S` la condición debe mantenerse S segundos antes
+ * de alertar. Por ejemplo: `T-001 > 40`, `tipo:presion < 75`,
+ * `tipo:temperatura promedio 10 > 30 durante 60`.
+ */
+struct Regla {
+    int id;                             ///< Identificador de la regla
+    bool porTipo;                       ///< true si aplica a todos los sensores de un tipo
+    TipoSensor tipo;                    ///< Tipo objetivo (si porTipo)
+    char sensor[TAM_NOMBRE_SENSOR];     ///< Sensor objetivo (si no porTipo)
+    ComparadorRegla comparador;         ///< Comparación a evaluar
+    int ventana;                        ///< Lecturas promediadas (1 = lectura directa)
+    double umbral;                      ///< Umbral de la comparación
+    double duracion;                    ///< Segundos que debe sostenerse la condición
+    bool activa;                        ///< false si la regla fue dada de baja
+};
+
+/**
+ * @brief Motor de reglas evaluado de forma incremental
+ *
+ * Cada sensor (por manejador) guarda la lista de reglas que le aplican y un
+ * estado por regla: lectura anterior, anillo de la ventana con su suma
+ * corrida e inicio de la condición. Evaluar una lectura cuesta O(1) por regla
+ * aplicable, sin recorrer el historial. Las alertas se disparan por flanco
+ * (una vez al cumplirse la condición y de nuevo solo tras dejar de cumplirse)
+ * y se publican en una ColaAlertas sin bloqueos.
+ */
+class MotorReglas {
+public:
+    static const int MAX_REGLAS = 256;      ///< Reglas que admite el motor
+    static const int MAX_VENTANA = 64;      ///< Lecturas máximas de una ventana de promedio
+
+private:
+    /**
+     * @brief Estado incremental de una regla para un sensor
+     */
+    struct EstadoRegla {
+        int regla;                          ///< Índice de la regla en el arreglo
+        double anterior;                    ///< Lectura anterior (para VARIACION)
+        bool hayAnterior;                   ///< Si ya hubo una lectura anterior
+        double* ventana;                    ///< Anillo de la ventana (nullptr si ventana = 1)
+        int posicion;                       ///< Siguiente ranura del anillo
+        int llenas;                         ///< Ranuras ocupadas del anillo
+        double sumaVentana;                 ///< Suma de las lecturas del anillo
+        double inicioCondicion;             ///< Marca de tiempo en que empezó a cumplirse (-1 = no)
+        bool disparada;                     ///< Si ya alertó en el flanco actual
+    };
+
+    /**
+     * @brief Reglas aplicables a un manejador
+     */
+    struct EnlaceSensor {
+        EstadoRegla* estados;               ///< Estado por regla aplicable
+        int cantidad;                       ///< Reglas aplicables
+        int capacidad;                      ///< Estados reservados
+        int revisadas;                      ///< Reglas del motor ya consideradas
+    };
+
+    Regla reglas[MAX_REGLAS];               ///< Reglas compiladas (solo se agregan)
+    int numReglas;                          ///< Reglas compiladas
+    EnlaceSensor* enlaces;                  ///< Enlaces indexados por manejador
+    int capacidadEnlaces;                   ///< Manejadores con enlace reservado
+    ColaAlertas alertas;                    ///< Alertas pendientes de atender
+
+public:
+    /**
+     * @brief Constructor
+     */
+    MotorReglas();
+
+    /**
+     * @brief Destructor
+     */
+    ~MotorReglas();
+
+    /**
+     * @brief Compila y agrega una regla
+     * @param especificacion Texto de la regla (ver Regla)
+     * @return Identificador de la regla, o -1 si la especificación es inválida
+     */
+    int agregarRegla(const char* especificacion);
+
+    /**
+     * @brief Da de baja una regla
+     * @param id Identificador de la regla
+     * @return true si la regla existía y estaba activa
+     */
+    bool eliminarRegla(int id);
+
+    /**
+     * @brief Evalúa una lectura contra las reglas que aplican al sensor
+     * @param manejador Manejador del sensor
+     * @param tipo Tipo del sensor
+     * @param nombre Nombre del sensor
+     * @param valor Lectura (ya convertida al tipo del sensor)
+     * @param marcaTiempo Marca de tiempo (s) de la lectura
+     */
+    void evaluar(unsigned int manejador, TipoSensor tipo, const char* nombre,
+                 double valor, double marcaTiempo);
+
+    /**
+     * @brief Descarta el estado de un manejador dado de baja
+     * @param manejador Manejador liberado
+     */
+    void olvidarSensor(unsigned int manejador);
+
+    /**
+     * @brief Obtiene una regla por identificador
+     * @param id Identificador de la regla
+     * @return Puntero a la regla, o nullptr si no existe
+     */
+    const Regla* obtenerRegla(int id) const;
+
+    /**
+     * @brief Obtiene el número de reglas compiladas (activas o no)
+     * @return Número de reglas
+     */
+    int obtenerCantidad() const;
+
+    /**
+     * @brief Cola donde se publican las alertas
+     * @return Referencia a la cola de alertas
+     */
+    ColaAlertas& obtenerAlertas();
+
+    /**
+     * @brief Escribe una regla con la sintaxis de su especificación
+     * @param regla Regla a describir
+     * @param salida Flujo de salida
+     */
+    static void describir(const Regla& regla, std::ostream& salida);
+
+private:
+    /**
+     * @brief Considera para un enlace las reglas agregadas desde su última revisión
+     * @param enlace Enlace a actualizar
+     * @param tipo Tipo del sensor
+     * @param nombre Nombre del sensor
+     */
+    void actualizarEnlace(EnlaceSensor& enlace, TipoSensor tipo, const char* nombre);
+
+    /**
+     * @brief Libera los estados de un enlace y lo deja vacío
+     * @param enlace Enlace a limpiar
+     */
+    static void limpiarEnlace(EnlaceSensor& enlace);
+
+    MotorReglas(const MotorReglas&);             ///< No copiable
+    MotorReglas& operator=(const MotorReglas&);  ///< No asignable
+};
+
+#endif // MOTOR_REGLAS_H
@@ -0,0 +1,62 @@
+/**
+ * @file PerfilComandos.h
+ * @brief Rendimiento y latencia por tipo de comando en el modo script
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef PERFIL_COMANDOS_H
+#define PERFIL_COMANDOS_H
+
+#include "EstadisticaFlujo.h"
+#include <iostream>
+
+/**
+ * @brief Acumula la duración de cada comando ejecutado, agrupada por opción
+ *
+ * Cada tipo de comando guarda sus latencias en un EstadisticaFlujo, de modo
+ * que el reporte incluye media, cuantiles y máximo con memoria constante sin
+ * importar cuántos comandos tenga el script.
+ */
+class PerfilComandos {
+public:
+    static const int MAX_OPCIONES = 32;  ///< Opciones de menú distinguibles (0 = inválida)
+
+private:
+    EstadisticaFlujo latencias[MAX_OPCIONES];  ///< Latencias (s) por opción
+    double inicio;                             ///< Instante monótono de iniciar()
+    double fin;                                ///< Instante monótono de terminar()
+
+public:
+    /**
+     * @brief Constructor
+     */
+    PerfilComandos();
+
+    /**
+     * @brief Marca el comienzo de la carga de trabajo
+     */
+    void iniciar();
+
+    /**
+     * @brief Marca el final de la carga de trabajo
+     */
+    void terminar();
+
+    /**
+     * @brief Registra la ejecución de un comando
+     * @param opcion Opción del menú (fuera de rango se cuenta como inválida)
+     * @param segundos Duración del comando
+     */
+    void registrar(int opcion, double segundos);
+
+    /**
+     * @brief Imprime el reporte de rendimiento por tipo de comando
+     * @param salida Flujo de salida
+     * @param nombres Nombre de cada opción (nombres[i] para la opción i; puede ser nullptr)
+     * @param numNombres Entradas de nombres
+     */
+    void imprimirReporte(std::ostream& salida, const char* const* nombres, int numNombres) const;
+};
+
+#endif // PERFIL_COMANDOS_H
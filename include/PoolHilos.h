@@ -0,0 +1,88 @@
+/**
+ * @file PoolHilos.h
+ * @brief Grupo fijo de hilos para repartir tareas indexadas
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef POOL_HILOS_H
+#define POOL_HILOS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Tarea ejecutable por el pool
+ * @param indice Índice de la tarea (0..numTareas-1)
+ * @param contexto Dato opaco suministrado por el llamador
+ */
+typedef void (*TareaPool)(int indice, void* contexto);
+
+/**
+ * @brief Hilos trabajadores que ejecutan en paralelo las tareas 0..n-1
+ *
+ * ejecutar() reparte los índices dinámicamente (cada hilo toma el siguiente
+ * índice libre) y no vuelve hasta que todos terminaron; el hilo que llama
+ * también trabaja. Los hilos se crean una sola vez y esperan dormidos entre
+ * llamadas. Qué hilo ejecuta cada índice no está determinado, así que las
+ * tareas deben escribir su resultado en una posición propia de su índice.
+ */
+class PoolHilos {
+private:
+    std::thread* hilos;                   ///< Hilos trabajadores
+    int numHilos;                         ///< Hilos trabajadores (sin contar al llamador)
+    std::mutex candado;                   ///< Protege el estado de la ronda
+    std::condition_variable hayTrabajo;   ///< Despierta a los trabajadores
+    std::condition_variable terminaron;   ///< Avisa al llamador del fin de la ronda
+    TareaPool tarea;                      ///< Tarea de la ronda en curso
+    void* contexto;                       ///< Contexto de la ronda en curso
+    int numTareas;                        ///< Índices de la ronda en curso
+    std::atomic<int> siguienteTarea;      ///< Siguiente índice sin asignar
+    int trabajando;                       ///< Trabajadores que no terminaron la ronda
+    unsigned long ronda;                  ///< Número de ronda (despierta a los trabajadores)
+    bool detener;                         ///< Si los trabajadores deben terminar
+
+public:
+    /**
+     * @brief Constructor - arranca los hilos trabajadores
+     * @param numHilos Trabajadores; 0 usa los núcleos disponibles menos uno
+     */
+    explicit PoolHilos(int numHilos = 0);
+
+    /**
+     * @brief Destructor - detiene y espera a los trabajadores
+     */
+    ~PoolHilos();
+
+    /**
+     * @brief Ejecuta tarea(i, contexto) para i = 0..numTareas-1 y espera
+     * @param numTareas Número de índices
+     * @param tarea Función a ejecutar
+     * @param contexto Dato opaco para la tarea
+     */
+    void ejecutar(int numTareas, TareaPool tarea, void* contexto);
+
+    /**
+     * @brief Número de hilos que trabajan en cada ronda (incluido el llamador)
+     * @return Hilos de cómputo
+     */
+    int obtenerNumHilos() const;
+
+private:
+    /**
+     * @brief Bucle de un hilo trabajador
+     */
+    void trabajar();
+
+    /**
+     * @brief Toma y ejecuta índices hasta agotar la ronda
+     */
+    void procesarTareas();
+
+    PoolHilos(const PoolHilos&);             ///< No copiable
+    PoolHilos& operator=(const PoolHilos&);  ///< No asignable
+};
+
+#endif // POOL_HILOS_H
@@ -0,0 +1,215 @@
+/**
+ * @file PoolNodos.h
+ * @brief Reserva de nodos por bloques (losas) para las listas de lecturas
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef POOL_NODOS_H
+#define POOL_NODOS_H
+
+#include "Nodo.h"
+#include "MemoriaHistorial.h"
+#include <cstddef>
+#include <new>
+
+/**
+ * @brief Reserva de nodos Nodo<T> agrupados en losas contiguas
+ *
+ * En lugar de una llamada al asignador por lectura, los nodos se toman de
+ * losas que contienen muchos nodos; los nodos liberados vuelven a una lista
+ * de libres y se reutilizan. reservar() permite pedir de una vez el espacio
+ * para un lote completo de lecturas.
+ *
+ * Si MemoriaHistorial está habilitado, las losas salen de sus arenas: el
+ * pool queda asociado al nodo NUMA del hilo que reservó su primera losa.
+ *
+ * @tparam T Tipo de dato de los nodos
+ */
+template <typename T>
+class PoolNodos
+{
+public:
+    static const int MIN_NODOS_LOSA = 16;   ///< Tamaño de la primera losa
+    static const int MAX_NODOS_LOSA = 4096; ///< Tamaño máximo de losa por crecimiento
+
+private:
+    /**
+     * @brief Encabezado de una losa; los nodos le siguen en memoria
+     */
+    struct Losa
+    {
+        Losa *siguiente;   ///< Siguiente losa reservada
+        int capacidad;     ///< Nodos que contiene la losa
+        int nodo;          ///< Nodo NUMA de la arena (-1 = operator new)
+        std::size_t bytes; ///< Tamaño reservado (para devolverla a su arena)
+    };
+
+    Losa *losas;         ///< Losas reservadas
+    Nodo<T> *libres;     ///< Lista de nodos libres (enlazados por siguiente)
+    int numLibres;       ///< Nodos en la lista de libres
+    int nodosReservados; ///< Nodos totales en todas las losas
+    int siguienteLosa;   ///< Tamaño de la próxima losa por crecimiento
+    int nodo;            ///< Nodo NUMA asociado (-1 = aún sin asociar)
+
+public:
+    /**
+     * @brief Constructor (no reserva memoria)
+     */
+    PoolNodos() : losas(nullptr), libres(nullptr), numLibres(0), nodosReservados(0),
+                  siguienteLosa(MIN_NODOS_LOSA), nodo(-1) {}
+
+    /**
+     * @brief Destructor - devuelve todas las losas al asignador
+     */
+    ~PoolNodos()
+    {
+        liberarTodo();
+    }
+
+    /**
+     * @brief Garantiza que haya al menos n nodos libres
+     * @param n Número de nodos requeridos
+     */
+    void reservar(int n)
+    {
+        if (numLibres < n)
+        {
+            agregarLosa(n - numLibres);
+        }
+    }
+
+    /**
+     * @brief Construye un nodo con el valor indicado
+     * @param valor Valor del nodo
+     * @return Nodo nuevo con siguiente = nullptr
+     */
+    Nodo<T> *crear(const T &valor)
+    {
+        if (libres == nullptr)
+        {
+            agregarLosa(siguienteLosa);
+            if (siguienteLosa < MAX_NODOS_LOSA)
+            {
+                siguienteLosa *= 2;
+            }
+        }
+        Nodo<T> *nodo = libres;
+        libres = libres->siguiente;
+        numLibres--;
+        return new (nodo) Nodo<T>(valor);
+    }
+
+    /**
+     * @brief Devuelve un nodo a la lista de libres
+     * @param nodo Nodo obtenido con crear()
+     */
+    void liberar(Nodo<T> *nodo)
+    {
+        nodo->~Nodo<T>();
+        nodo->siguiente = libres;
+        libres = nodo;
+        numLibres++;
+    }
+
+    /**
+     * @brief Devuelve todas las losas al asignador
+     *
+     * Solo debe llamarse cuando ningún nodo del pool sigue en uso.
+     */
+    void liberarTodo()
+    {
+        while (losas != nullptr)
+        {
+            Losa *temp = losas;
+            losas = losas->siguiente;
+            if (temp->nodo >= 0)
+            {
+                MemoriaHistorial::global().liberar(temp, temp->bytes, temp->nodo);
+            }
+            else
+            {
+                ::operator delete(temp);
+            }
+        }
+        libres = nullptr;
+        numLibres = 0;
+        nodosReservados = 0;
+        siguienteLosa = MIN_NODOS_LOSA;
+    }
+
+    /**
+     * @brief Bytes reservados por las losas del pool
+     * @return Memoria ocupada por nodos en uso y libres
+     */
+    std::size_t bytesReservados() const
+    {
+        return sizeof(Nodo<T>) * static_cast<std::size_t>(nodosReservados);
+    }
+
+    /**
+     * @brief Nodo NUMA al que está asociado el pool
+     * @return Índice de nodo, o -1 si sus losas no salen de MemoriaHistorial
+     */
+    int obtenerNodo() const
+    {
+        return nodo;
+    }
+
+private:
+    /**
+     * @brief Desplazamiento de los nodos respecto del inicio de la losa
+     */
+    static std::size_t desplazamientoNodos()
+    {
+        std::size_t alineacion = alignof(Nodo<T>);
+        return (sizeof(Losa) + alineacion - 1) / alineacion * alineacion;
+    }
+
+    /**
+     * @brief Reserva una losa nueva y encadena sus nodos como libres
+     * @param n Número de nodos de la losa
+     */
+    void agregarLosa(int n)
+    {
+        std::size_t bytes = desplazamientoNodos() + sizeof(Nodo<T>) * static_cast<std::size_t>(n);
+        void *memoria;
+        int nodoLosa = -1;
+        MemoriaHistorial &respaldo = MemoriaHistorial::global();
+        if (respaldo.estaHabilitado())
+        {
+            if (nodo < 0)
+            {
+                nodo = respaldo.nodoActual();
+            }
+            memoria = respaldo.reservar(bytes, nodo, bytes);
+            nodoLosa = nodo;
+            // La losa se redondea: se aprovecha el espacio sobrante
+            n = static_cast<int>((bytes - desplazamientoNodos()) / sizeof(Nodo<T>));
+        }
+        else
+        {
+            memoria = ::operator new(bytes);
+        }
+        Losa *losa = static_cast<Losa *>(memoria);
+        losa->siguiente = losas;
+        losa->capacidad = n;
+        losa->nodo = nodoLosa;
+        losa->bytes = bytes;
+        losas = losa;
+
+        Nodo<T> *nodos = reinterpret_cast<Nodo<T> *>(static_cast<unsigned char *>(memoria) + desplazamientoNodos());
+        for (int i = n - 1; i >= 0; i--)
+        {
+            nodos[i].siguiente = libres;
+            libres = &nodos[i];
+        }
+        numLibres += n;
+        nodosReservados += n;
+    }
+
+    PoolNodos(const PoolNodos &);            ///< No copiable
+    PoolNodos &operator=(const PoolNodos &); ///< No asignable
+};
+
+#endif // POOL_NODOS_H
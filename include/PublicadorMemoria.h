@@ -0,0 +1,127 @@
+/**
+ * @file PublicadorMemoria.h
+ * @brief Publicación de lecturas y estadísticas en memoria compartida POSIX
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef PUBLICADOR_MEMORIA_H
+#define PUBLICADOR_MEMORIA_H
+
+#include "SegmentoSensores.h"
+
+/**
+ * @brief Escritor del segmento compartido de sensores
+ *
+ * El proceso de ingesta crea el segmento (shm_open + mmap) y, por cada
+ * lectura, escribe en el anillo de la ranura del sensor y actualiza sus
+ * estadísticas bajo el seqlock. Los procesos de consulta mapean el mismo
+ * segmento en solo lectura (ver LectorMemoria). La ranura de un sensor es
+ * su manejador en el RegistroColumnar; los manejadores que no caben en el
+ * segmento no se publican, y el primero de ellos se advierte por consola.
+ *
+ * En plataformas sin memoria compartida POSIX abrir() devuelve false.
+ */
+class PublicadorMemoria {
+public:
+    static const int RANURAS_POR_DEFECTO = 256;  ///< Ranuras si no se indica otra cantidad
+
+private:
+    char nombreSegmento[TAM_NOMBRE_SENSOR];  ///< Nombre POSIX del segmento
+    void* mapeo;                             ///< Inicio del segmento mapeado
+    std::size_t tamano;                      ///< Bytes mapeados
+    RanuraSensor* ranuras;                   ///< Primera ranura del segmento
+    std::uint32_t numRanuras;                ///< Ranuras del segmento
+    std::atomic<bool> advertidoFuera;        ///< Si ya se advirtió de un manejador sin ranura
+
+public:
+    /**
+     * @brief Constructor (no crea el segmento)
+     */
+    PublicadorMemoria();
+
+    /**
+     * @brief Destructor - desmapea y elimina el segmento
+     */
+    ~PublicadorMemoria();
+
+    /**
+     * @brief Crea y mapea el segmento
+     *
+     * Si ya existe uno con ese nombre solo se reemplaza cuando su escritor
+     * terminó; si sigue publicando, abrir() falla y no lo toca.
+     *
+     * @param nombre Nombre POSIX del segmento (debe empezar con '/')
+     * @param numRanuras Número de ranuras (sensores publicables)
+     * @return true si el segmento quedó listo para publicar
+     */
+    bool abrir(const char* nombre, int numRanuras = RANURAS_POR_DEFECTO);
+
+    /**
+     * @brief Desmapea y elimina el segmento
+     */
+    void cerrar();
+
+    /**
+     * @brief Indica si hay un segmento abierto
+     * @return true si abrir() tuvo éxito
+     */
+    bool estaAbierto() const;
+
+    /**
+     * @brief Publica el alta de un sensor (ranura activa y sin lecturas)
+     * @param manejador Manejador del sensor
+     * @param sensor Sensor dado de alta
+     * @param marcaTiempo Marca de tiempo (s) del alta
+     */
+    void publicarAlta(unsigned int manejador, const SensorBase& sensor, double marcaTiempo);
+
+    /**
+     * @brief Publica lecturas nuevas de un sensor y sus estadísticas
+     * @param manejador Manejador del sensor
+     * @param sensor Sensor que recibió las lecturas
+     * @param valores Lecturas (ya convertidas al tipo del sensor) en orden de llegada
+     * @param cantidad Número de lecturas
+     * @param marcaTiempo Marca de tiempo (s) de la última lectura
+     */
+    void publicarLecturas(unsigned int manejador, const SensorBase& sensor,
+                          const double* valores, int cantidad, double marcaTiempo);
+
+    /**
+     * @brief Marca la ranura de un sensor dado de baja como inactiva
+     * @param manejador Manejador liberado
+     */
+    void publicarBaja(unsigned int manejador);
+
+private:
+    /**
+     * @brief Comprueba que un manejador tenga ranura en el segmento
+     *
+     * La primera vez que no la tiene lo advierte por consola.
+     *
+     * @param manejador Manejador del sensor
+     * @param sensor Sensor del manejador
+     * @return true si el manejador puede publicarse
+     */
+    bool tieneRanura(unsigned int manejador, const SensorBase& sensor);
+
+    /**
+     * @brief Reescribe las estadísticas de una ranura bajo el seqlock
+     * @param ranura Ranura a actualizar
+     * @param estadisticas Nuevo contenido
+     */
+    static void escribirEstadisticas(RanuraSensor& ranura, const EstadisticaPublicada& estadisticas);
+
+    /**
+     * @brief Arma las estadísticas publicables de un sensor
+     * @param sensor Sensor a resumir
+     * @param marcaTiempo Marca de tiempo (s) de la última lectura o del alta
+     * @return Estadísticas con la ranura activa
+     */
+    static EstadisticaPublicada resumir(const SensorBase& sensor, double marcaTiempo);
+
+    PublicadorMemoria(const PublicadorMemoria&);             ///< No copiable
+    PublicadorMemoria& operator=(const PublicadorMemoria&);  ///< No asignable
+};
+
+#endif // PUBLICADOR_MEMORIA_H
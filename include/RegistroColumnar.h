@@ -0,0 +1,356 @@
+/**
+ * @file RegistroColumnar.h
+ * @brief Registro de sensores con metadatos en columnas contiguas (struct-of-arrays)
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef REGISTRO_COLUMNAR_H
+#define REGISTRO_COLUMNAR_H
+
+#include "SensorBase.h"
+
+class PoolHilos;
+
+/**
+ * @brief Vista de solo lectura de una fila del registro
+ *
+ * Se entrega a los predicados de baja masiva para que decidan sobre un
+ * sensor sin tener que tocar su historial.
+ */
+struct ResumenSensor {
+    unsigned int manejador;   ///< Manejador (ID estable) del sensor
+    TipoSensor tipo;          ///< Tipo del sensor
+    const char* nombre;       ///< Nombre del sensor
+    long long numLecturas;    ///< Lecturas ingeridas
+    double suma;              ///< Suma de las lecturas ingeridas
+    double minimo;            ///< Lectura mínima ingerida
+    double maximo;            ///< Lectura máxima ingerida
+    double ultimaLectura;     ///< Marca de tiempo (s) de la última lectura o del alta
+};
+
+/**
+ * @brief Condición sobre el promedio de ingesta de un sensor
+ */
+enum class FiltroPromedio {
+    NINGUNO,    ///< Todos los sensores cumplen
+    MAYOR_QUE,  ///< Promedio estrictamente mayor que el umbral
+    MENOR_QUE   ///< Promedio estrictamente menor que el umbral
+};
+
+/**
+ * @brief Selección de sensores para una consulta de flota
+ *
+ * Un sensor sin lecturas no tiene promedio, así que solo cumple el filtro
+ * NINGUNO.
+ */
+struct ConsultaFlota {
+    bool porTipo;            ///< Si se restringe a un tipo de sensor
+    TipoSensor tipo;         ///< Tipo requerido (si porTipo)
+    FiltroPromedio filtro;   ///< Condición sobre el promedio de ingesta
+    double umbral;           ///< Umbral del filtro
+};
+
+/**
+ * @brief Resultado de una consulta de flota
+ */
+struct AgregadoFlota {
+    int sensores;                ///< Sensores que cumplen la consulta
+    int conLecturas;             ///< De ellos, los que tienen al menos una lectura
+    long long lecturas;          ///< Lecturas ingeridas por los sensores seleccionados
+    double media;                ///< Media de todas sus lecturas (0 si no hay)
+    double promedioDePromedios;  ///< Media de los promedios por sensor (0 si no hay)
+    double minimo;               ///< Lectura mínima (0 si no hay)
+    double maximo;               ///< Lectura máxima (0 si no hay)
+};
+
+/**
+ * @brief Registro columnar de sensores
+ *
+ * Cada sensor ocupa una fila; sus metadatos (tipo, nombre, número de lecturas
+ * y estadísticas acumuladas de ingesta) se guardan en arreglos paralelos, de
+ * modo que los recorridos de toda la flota avanzan de forma lineal por memoria
+ * sin saltar de nodo en nodo. El historial pesado (el objeto SensorBase con su
+ * ListaSensor<T>) se referencia mediante un manejador estable que no cambia
+ * aunque las filas se reacomoden.
+ *
+ * El registro no es dueño de los sensores: solo guarda sus punteros.
+ */
+class RegistroColumnar {
+public:
+    /**
+     * @brief Valor que indica la ausencia de un manejador válido
+     */
+    static const unsigned int SIN_MANEJADOR = 0xFFFFFFFFu;
+
+private:
+    static const unsigned int TUMBA = 0xFFFFFFFEu;  ///< Ranura del índice liberada
+
+    // --- Columnas (una entrada por fila, índices 0..cantidad-1) ---
+    TipoSensor* tipos;                   ///< Etiqueta de tipo de cada fila
+    unsigned int* manejadores;           ///< Manejador de historial de cada fila
+    char (*nombres)[TAM_NOMBRE_SENSOR];  ///< Nombre de cada fila
+    long long* numLecturas;              ///< Lecturas ingeridas por fila
+    double* sumas;                       ///< Suma de las lecturas ingeridas
+    double* minimos;                     ///< Lectura mínima ingerida
+    double* maximos;                     ///< Lectura máxima ingerida
+    double* ultimasLecturas;             ///< Marca de tiempo de la última lectura
+    int cantidad;                        ///< Número de filas ocupadas
+    int capacidad;                       ///< Filas reservadas en cada columna
+
+    // --- Tabla de manejadores (indexada por manejador) ---
+    SensorBase** sensores;               ///< Sensor referenciado por cada manejador
+    int* filaPorManejador;               ///< Fila del manejador, o siguiente libre
+    int capacidadManejadores;            ///< Entradas reservadas en la tabla
+    int primerLibre;                     ///< Cabeza de la lista de manejadores libres
+    unsigned long long* generaciones;    ///< Cambios de estadísticas de cada manejador
+    unsigned long long* procesadas;      ///< Generación vista por el último procesamiento
+
+    // --- Manejadores modificados desde el último procesamiento ---
+    unsigned int* pendientes;            ///< Manejadores en orden de primera modificación
+    int numPendientes;                   ///< Entradas ocupadas (puede haber obsoletas)
+    int capacidadPendientes;             ///< Entradas reservadas
+
+    // --- Índice de nombres (direccionamiento abierto) ---
+    unsigned int* indice;                ///< Manejadores indexados por hash de nombre
+    int capacidadIndice;                 ///< Ranuras del índice (potencia de 2)
+    int ocupadasIndice;                  ///< Ranuras ocupadas del índice
+    int tumbasIndice;                    ///< Ranuras marcadas como liberadas
+
+public:
+    /**
+     * @brief Constructor
+     * @param capacidadInicial Número de filas a reservar de inicio
+     */
+    RegistroColumnar(int capacidadInicial = 16);
+
+    /**
+     * @brief Destructor - libera las columnas (no los sensores)
+     */
+    ~RegistroColumnar();
+
+    /**
+     * @brief Agrega un sensor al registro
+     * @param sensor Sensor a registrar
+     * @param marcaTiempo Marca de tiempo (s) del alta
+     * @return Manejador asignado, o SIN_MANEJADOR si el nombre ya existe
+     */
+    unsigned int agregar(SensorBase* sensor, double marcaTiempo = 0.0);
+
+    /**
+     * @brief Quita un sensor del registro en tiempo constante
+     *
+     * La última fila ocupa el lugar de la eliminada, el manejador vuelve a la
+     * lista de libres y el nombre se retira del índice. Las columnas se
+     * encogen cuando quedan ocupadas menos de una cuarta parte. No libera el
+     * sensor: eso corresponde a su dueño.
+     *
+     * @param manejador Manejador del sensor
+     * @return Sensor que estaba registrado, o nullptr si el manejador no es válido
+     */
+    SensorBase* eliminar(unsigned int manejador);
+
+    /**
+     * @brief Busca un sensor por nombre en tiempo constante esperado
+     * @param nombre Nombre del sensor
+     * @return Manejador del sensor, o SIN_MANEJADOR si no existe
+     */
+    unsigned int buscar(const char* nombre) const;
+
+    /**
+     * @brief Obtiene el sensor referenciado por un manejador
+     * @param manejador Manejador del sensor
+     * @return Puntero al sensor, o nullptr si el manejador no es válido
+     */
+    SensorBase* obtenerSensor(unsigned int manejador) const;
+
+    /**
+     * @brief Obtiene la fila que ocupa actualmente un manejador
+     * @param manejador Manejador del sensor
+     * @return Índice de fila, o -1 si el manejador no es válido
+     */
+    int obtenerFila(unsigned int manejador) const;
+
+    /**
+     * @brief Acumula una lectura ingerida en las estadísticas de la fila
+     * @param manejador Manejador del sensor que recibió la lectura
+     * @param valor Valor de la lectura
+     * @param marcaTiempo Marca de tiempo (s) de la lectura
+     */
+    void acumularLectura(unsigned int manejador, double valor, double marcaTiempo);
+
+    /**
+     * @brief Reemplaza las estadísticas de la fila por las del sensor
+     *
+     * Se usa tras un lote de lecturas: la fila se actualiza una sola vez a
+     * partir de los estimadores que el sensor ya mantiene.
+     *
+     * @param manejador Manejador del sensor
+     * @param estadisticas Estimadores en flujo del sensor
+     * @param marcaTiempo Marca de tiempo (s) de la última lectura
+     */
+    void sincronizarFila(unsigned int manejador, const EstadisticaFlujo& estadisticas, double marcaTiempo);
+
+    /**
+     * @brief Indica si un sensor recibió lecturas desde su último procesamiento
+     * @param manejador Manejador del sensor
+     * @return true si su generación no fue procesada (false si el manejador no es válido)
+     */
+    bool estaModificado(unsigned int manejador) const;
+
+    /**
+     * @brief Obtiene el número de cambios de estadísticas de un sensor
+     * @param manejador Manejador del sensor
+     * @return Generación actual (0 si nunca recibió lecturas o no es válido)
+     */
+    unsigned long long obtenerGeneracion(unsigned int manejador) const;
+
+    /**
+     * @brief Marca la generación actual de un sensor como procesada
+     * @param manejador Manejador del sensor
+     */
+    void marcarProcesado(unsigned int manejador);
+
+    /**
+     * @brief Manejadores modificados desde el último vaciarPendientes()
+     *
+     * Cada sensor aparece al pasar de procesado a modificado, por lo que el
+     * recorrido cuesta en proporción a los sensores con datos nuevos. Puede
+     * haber entradas obsoletas (sensores dados de baja, o ya procesados);
+     * se descartan con estaModificado().
+     *
+     * @return Arreglo de obtenerNumPendientes() manejadores
+     */
+    const unsigned int* listaPendientes() const;
+
+    /**
+     * @brief Obtiene el número de entradas de listaPendientes()
+     * @return Entradas de la lista
+     */
+    int obtenerNumPendientes() const;
+
+    /**
+     * @brief Vacía la lista de pendientes
+     *
+     * Los sensores que sigan modificados dejan de figurar en ella, así que
+     * solo debe llamarse tras marcarlos como procesados.
+     */
+    void vaciarPendientes();
+
+    /**
+     * @brief Obtiene la vista resumida de una fila
+     * @param fila Índice de fila (0..obtenerCantidad()-1)
+     * @return Resumen de la fila
+     */
+    ResumenSensor obtenerResumen(int fila) const;
+
+    /**
+     * @brief Reserva espacio para al menos la cantidad indicada de filas
+     *
+     * También amplía la tabla de manejadores y dimensiona el índice de
+     * nombres para esa cantidad, de modo que las altas siguientes no
+     * redimensionan nada.
+     *
+     * @param nuevaCapacidad Número de filas requeridas
+     */
+    void reservar(int nuevaCapacidad);
+
+    /**
+     * @brief Calcula el promedio de los promedios de ingesta de todas las filas
+     * @return Promedio de promedios (0 si ningún sensor tiene lecturas)
+     */
+    double promedioDePromedios() const;
+
+    /**
+     * @brief Agrega las estadísticas de ingesta de los sensores seleccionados
+     *
+     * Las filas se dividen en tramos de tamaño fijo que se reducen en paralelo
+     * y los parciales se combinan en orden de tramo. Como el corte no depende
+     * del número de hilos, las sumas en punto flotante dan el mismo resultado
+     * con cualquier pool (o sin él).
+     *
+     * @param consulta Selección de sensores
+     * @param hilos Pool con el que repartir los tramos (nullptr: secuencial)
+     * @return Agregado de la selección
+     */
+    AgregadoFlota consultar(const ConsultaFlota& consulta, PoolHilos* hilos) const;
+
+    /**
+     * @brief Obtiene el número de sensores registrados
+     * @return Número de filas ocupadas
+     */
+    int obtenerCantidad() const;
+
+    /**
+     * @brief Obtiene la capacidad de la tabla de manejadores
+     * @return Cota (exclusiva) de los manejadores entregados hasta ahora
+     */
+    int obtenerCapacidadManejadores() const;
+
+    /**
+     * @brief Verifica si el registro está vacío
+     * @return true si no hay sensores registrados
+     */
+    bool estaVacio() const;
+
+    /// @name Acceso de solo lectura a las columnas (filas 0..obtenerCantidad()-1)
+    /// @{
+    const TipoSensor* columnaTipos() const { return tipos; }
+    const unsigned int* columnaManejadores() const { return manejadores; }
+    const char (*columnaNombres() const)[TAM_NOMBRE_SENSOR] { return nombres; }
+    const long long* columnaLecturas() const { return numLecturas; }
+    const double* columnaSumas() const { return sumas; }
+    const double* columnaMinimos() const { return minimos; }
+    const double* columnaMaximos() const { return maximos; }
+    const double* columnaUltimasLecturas() const { return ultimasLecturas; }
+    /// @}
+
+private:
+    RegistroColumnar(const RegistroColumnar&);             ///< No copiable
+    RegistroColumnar& operator=(const RegistroColumnar&);  ///< No asignable
+
+    /**
+     * @brief Cambia la capacidad de las columnas y del índice
+     * @param nuevaCapacidad Número de filas (>= cantidad)
+     */
+    void ajustarCapacidad(int nuevaCapacidad);
+
+    /**
+     * @brief Reserva una entrada en la tabla de manejadores
+     * @return Manejador libre
+     */
+    unsigned int tomarManejador();
+
+    /**
+     * @brief Amplía la tabla de manejadores y encadena las entradas nuevas como libres
+     * @param nuevaCapacidad Entradas de la tabla (> capacidadManejadores)
+     */
+    void crecerManejadores(int nuevaCapacidad);
+
+    /**
+     * @brief Inserta un manejador en el índice de nombres
+     * @param manejador Manejador cuya fila ya contiene el nombre
+     */
+    void indexar(unsigned int manejador);
+
+    /**
+     * @brief Avanza la generación de un sensor y lo anota como pendiente
+     * @param manejador Manejador del sensor
+     */
+    void marcarModificado(unsigned int manejador);
+
+    /**
+     * @brief Reconstruye el índice de nombres con la capacidad indicada
+     * @param nuevaCapacidad Número de ranuras (potencia de 2)
+     */
+    void reconstruirIndice(int nuevaCapacidad);
+
+    /**
+     * @brief Función hash FNV-1a sobre el nombre
+     * @param nombre Cadena terminada en nulo
+     * @return Valor hash de 32 bits
+     */
+    static unsigned int hashNombre(const char* nombre);
+};
+
+#endif // REGISTRO_COLUMNAR_H
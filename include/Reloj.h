@@ -0,0 +1,31 @@
+/**
+ * @file Reloj.h
+ * @brief Utilidad para obtener marcas de tiempo de las lecturas
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef RELOJ_H
+#define RELOJ_H
+
+#include <chrono>
+
+/**
+ * @brief Obtiene la hora actual del sistema
+ * @return Segundos transcurridos desde la época Unix (con fracción)
+ */
+inline double segundosActuales() {
+    return std::chrono::duration<double>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Obtiene un instante de un reloj monótono para medir duraciones
+ * @return Segundos (con fracción) desde un origen arbitrario
+ */
+inline double segundosMonotonicos() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // RELOJ_H
@@ -0,0 +1,95 @@
+/**
+ * @file SegmentoSensores.h
+ * @brief Disposición en memoria compartida de las lecturas recientes y estadísticas
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef SEGMENTO_SENSORES_H
+#define SEGMENTO_SENSORES_H
+
+#include "SensorBase.h"
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Nombre por defecto del segmento POSIX de publicación
+ */
+const char* const NOMBRE_SEGMENTO_SENSORES = "/sensor_iot";
+
+/**
+ * @brief Estadísticas publicadas de un sensor (protegidas por el seqlock de su ranura)
+ */
+struct EstadisticaPublicada {
+    unsigned char activa;            ///< 1 si la ranura corresponde a un sensor vivo
+    TipoSensor tipo;                 ///< Tipo del sensor
+    char nombre[TAM_NOMBRE_SENSOR];  ///< Nombre del sensor
+    long long numLecturas;           ///< Lecturas ingeridas
+    double media;                    ///< Media de ingesta
+    double desviacion;               ///< Desviación estándar de ingesta
+    double minimo;                   ///< Menor lectura ingerida
+    double maximo;                   ///< Mayor lectura ingerida
+    double ultimaLectura;            ///< Marca de tiempo (s) de la última lectura o del alta
+    std::uint64_t inicioAnillo;      ///< Valor de `escritas` al alta (lecturas ajenas al sensor)
+};
+
+/**
+ * @brief Ranura de un sensor dentro del segmento (una por manejador)
+ *
+ * - Las estadísticas se protegen con un seqlock: el escritor deja la
+ *   secuencia impar mientras escribe y los lectores reintentan si la
+ *   secuencia cambió o era impar.
+ * - Las lecturas recientes forman un anillo: la lectura número i ocupa
+ *   anillo[i % LECTURAS_RECIENTES] y `escritas` cuenta las publicadas. Un
+ *   lector recorre el anillo en su lugar y solo confía en los índices
+ *   mayores que escritas - LECTURAS_RECIENTES releídos después del valor.
+ *   El contador nunca retrocede: cuando la ranura se reutiliza, inicioAnillo
+ *   marca dónde empiezan las lecturas del sensor nuevo.
+ *
+ * Ninguno de los dos mecanismos bloquea al escritor.
+ */
+struct RanuraSensor {
+    static const int LECTURAS_RECIENTES = 256;        ///< Capacidad del anillo
+
+    std::atomic<std::uint32_t> secuencia;             ///< Contador del seqlock
+    EstadisticaPublicada estadisticas;                ///< Datos protegidos por el seqlock
+    std::atomic<std::uint64_t> escritas;              ///< Lecturas publicadas en el anillo
+    std::atomic<double> anillo[LECTURAS_RECIENTES];   ///< Lecturas más recientes
+};
+
+/**
+ * @brief Encabezado del segmento
+ */
+struct EncabezadoSegmento {
+    static const std::uint32_t MAGIA = 0x534E5331u;   ///< Firma "SNS1"
+    static const std::uint32_t VERSION = 1;           ///< Versión de la disposición
+
+    std::uint32_t magia;                              ///< Debe valer MAGIA
+    std::uint32_t version;                            ///< Debe valer VERSION
+    std::uint32_t numRanuras;                         ///< Ranuras que siguen al encabezado
+    std::uint32_t lecturasRecientes;                  ///< RanuraSensor::LECTURAS_RECIENTES
+    std::int64_t pidEscritor;                         ///< Proceso que publica
+};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "el seqlock requiere atómicos sin bloqueo");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "el anillo requiere atómicos sin bloqueo");
+static_assert(std::atomic<double>::is_always_lock_free, "el anillo requiere atómicos sin bloqueo");
+
+/**
+ * @brief Desplazamiento de la primera ranura respecto del inicio del segmento
+ * @return Bytes que ocupa el encabezado, alineado para RanuraSensor
+ */
+inline std::size_t desplazamientoRanuras() {
+    return (sizeof(EncabezadoSegmento) + alignof(RanuraSensor) - 1) / alignof(RanuraSensor) * alignof(RanuraSensor);
+}
+
+/**
+ * @brief Tamaño total de un segmento
+ * @param numRanuras Ranuras del segmento
+ * @return Bytes necesarios
+ */
+inline std::size_t tamanoSegmento(std::uint32_t numRanuras) {
+    return desplazamientoRanuras() + sizeof(RanuraSensor) * numRanuras;
+}
+
+#endif // SEGMENTO_SENSORES_H
@@ -10,6 +10,81 @@
 
 #include <iostream>
 #include <cstring>
+#include <cstddef>
+#include <span>
+#include "EstadisticaFlujo.h"
+
+class ExportadorHistorial;
+
+/**
+ * @brief Longitud máxima (incluyendo el terminador nulo) del nombre de un sensor
+ */
+const int TAM_NOMBRE_SENSOR = 50;
+
+/**
+ * @brief Etiqueta que identifica el tipo concreto de un sensor
+ *
+ * Permite a los registros de gestión clasificar sensores sin recurrir
+ * a dynamic_cast en cada recorrido.
+ */
+enum class TipoSensor : unsigned char {
+    TEMPERATURA,  ///< Sensor con lecturas de tipo float
+    PRESION       ///< Sensor con lecturas de tipo int
+};
+
+/**
+ * @brief Textos propios de cada tipo de sensor (consola, manifiesto e ingesta)
+ */
+struct RasgosTipoSensor {
+    const char* nombre;            ///< Nombre legible ("Temperatura")
+    const char* clave;             ///< Clave en manifiestos, reglas y consultas ("temperatura")
+    const char* prefijoIngesta;    ///< Prefijo de las líneas de ingesta ("TEMP")
+    const char* lectura;           ///< Magnitud en los mensajes de lectura ("temperatura")
+    const char* clase;             ///< Nombre de la clase en el registro de alta
+    const char* nombrePorDefecto;  ///< Nombre de un sensor creado sin nombre
+    const char* etiqueta;          ///< Etiqueta de los mensajes de procesamiento ("[Sensor Temp]")
+    const char* etiquetaLectura;   ///< Etiqueta tras el nombre del sensor ("(Temperatura)")
+    const char* cierreInfo;        ///< Línea final de imprimirInfo(), del ancho de su encabezado
+};
+
+/**
+ * @brief Textos de un tipo de sensor
+ * @param tipo Etiqueta del tipo
+ * @return Rasgos del tipo
+ */
+constexpr RasgosTipoSensor rasgosTipoSensor(TipoSensor tipo) {
+    switch (tipo) {
+        case TipoSensor::TEMPERATURA:
+            return {"Temperatura", "temperatura", "TEMP", "temperatura", "SensorTemperatura", "Temp_Default",
+                    "Temp", "Temperatura", "============================================="};
+        case TipoSensor::PRESION:
+            return {"Presión", "presion", "PRES", "presión", "SensorPresion", "Presion_Default",
+                    "Presion", "Presion", "========================================="};
+    }
+    return {"Desconocido", "desconocido", "", "lectura", "Sensor", "Sensor_Default", "Sensor", "Sensor", "====="};
+}
+
+/**
+ * @brief Nombre legible de un tipo de sensor
+ * @param tipo Etiqueta del tipo
+ * @return Cadena constante con el nombre del tipo
+ */
+constexpr const char* nombreTipoSensor(TipoSensor tipo) {
+    return rasgosTipoSensor(tipo).nombre;
+}
+
+/**
+ * @brief Resultado de la última llamada a procesarLectura() de un sensor
+ *
+ * Se conserva para poder informarlo sin volver a procesar el historial.
+ */
+struct ResultadoProcesamiento {
+    bool procesado;          ///< Si el sensor se procesó alguna vez
+    int lecturas;            ///< Lecturas en el historial al procesar (0 = historial vacío)
+    double promedio;         ///< Promedio calculado (0 si no había lecturas)
+    bool minimoDescartado;   ///< Si se eliminó la lectura más baja
+    double minimo;           ///< Lectura eliminada (si minimoDescartado)
+};
 
 /**
  * @brief Clase base abstracta que define la interfaz común para todos los sensores
@@ -19,7 +94,8 @@
  */
 class SensorBase {
 protected:
-    char nombre[50];  ///< Identificador único del sensor
+    char nombre[TAM_NOMBRE_SENSOR];  ///< Identificador único del sensor
+    ResultadoProcesamiento ultimoProcesamiento;  ///< Resultado del último procesarLectura()
 
 public:
     /**
@@ -52,6 +128,76 @@ public:
      */
     virtual void imprimirInfo() const = 0;
     
+    /**
+     * @brief Método virtual puro que informa el tipo concreto del sensor
+     * @return Etiqueta del tipo de sensor
+     */
+    virtual TipoSensor obtenerTipo() const = 0;
+    
+    /**
+     * @brief Método virtual puro que expone los estimadores en flujo del sensor
+     * 
+     * Permite combinar (fusionar) las estadísticas de varios sensores sin
+     * conocer su tipo concreto
+     * 
+     * @return Media, desviación estándar y cuantiles de las lecturas ingeridas
+     */
+    virtual const EstadisticaFlujo& obtenerEstadisticas() const = 0;
+    
+    /**
+     * @brief Método virtual puro para activar el historial comprimido
+     * @param lecturasPorBloque Lecturas por bloque sellado (0 lo deshabilita)
+     */
+    virtual void habilitarCompresion(int lecturasPorBloque) = 0;
+    
+    /**
+     * @brief Método virtual puro que informa la memoria ocupada por el historial
+     * @return Bytes ocupados por las lecturas almacenadas
+     */
+    virtual std::size_t memoriaHistorial() const = 0;
+
+    /**
+     * @brief Método virtual puro para activar el índice de valores del historial
+     * @param minimoDenso Primer valor del dominio de conteo denso (sensores enteros)
+     * @param maximoDenso Último valor del dominio denso (menor que minimoDenso = sin dominio denso)
+     */
+    virtual void habilitarIndice(long long minimoDenso, long long maximoDenso) = 0;
+
+    /**
+     * @brief Método virtual puro para reservar de antemano espacio de historial
+     * @param lecturas Lecturas que se espera recibir
+     */
+    virtual void reservarLecturas(int lecturas) = 0;
+    
+    /**
+     * @brief Método virtual puro para registrar un lote de lecturas
+     * 
+     * Permite la ingesta masiva sin conocer el tipo concreto del sensor; cada
+     * valor se valida y se convierte una sola vez al tipo de lectura del
+     * sensor. Los valores no finitos o fuera del rango del tipo se descartan.
+     * 
+     * @param valores Lecturas en orden de llegada
+     * @param aceptadas Recibe, en orden, las lecturas registradas ya
+     *        convertidas (espacio para valores.size() elementos)
+     * @return Número de lecturas registradas
+     */
+    virtual int registrarLecturas(std::span<const double> valores, double* aceptadas) = 0;
+
+    /**
+     * @brief Método virtual puro para volcar el historial completo a un exportador
+     * 
+     * Escribe una instantánea coherente del historial aunque la ingesta
+     * continúe en otro hilo
+     * 
+     * @param exportador Exportador abierto que recibe el encabezado y las lecturas
+     */
+    virtual void exportar(ExportadorHistorial& exportador) const = 0;
+
+    /**
+     * @brief Método virtual puro para mostrar todas las lecturas registradas
+     */
+    virtual void mostrarHistorial() const = 0;
+    
     /**
      * @brief Obtiene el nombre del sensor
      * @return Puntero constante al nombre del sensor
@@ -63,6 +209,12 @@ public:
      * @param nombreSensor Nuevo nombre para el sensor
      */
     void establecerNombre(const char* nombreSensor);
+
+    /**
+     * @brief Obtiene el resultado del último procesamiento
+     * @return Resultado guardado por procesarLectura() (procesado = false si nunca se llamó)
+     */
+    const ResultadoProcesamiento& obtenerUltimoProcesamiento() const;
 };
 
 #endif // SENSOR_BASE_H
\ No newline at end of file
@@ -0,0 +1,439 @@
+/**
+ * @file SensorTipado.h
+ * @brief Sensor genérico parametrizado por tipo de lectura y política de procesamiento
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#ifndef SENSOR_TIPADO_H
+#define SENSOR_TIPADO_H
+
+#include "SensorBase.h"
+#include "ListaSensor.h"
+#include "ExportadorHistorial.h"
+#include <cmath>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+/**
+ * @brief Política de procesamiento: promedio de todas las lecturas
+ */
+struct PoliticaPromedio {
+    static constexpr bool descartarMinimo = false;  ///< Conserva todas las lecturas
+};
+
+/**
+ * @brief Política de procesamiento: elimina la lectura más baja y promedia el resto
+ */
+struct PoliticaDescartarMinimo {
+    static constexpr bool descartarMinimo = true;   ///< Descarta el mínimo antes de promediar
+};
+
+/**
+ * @brief Nombre del tipo de dato de las lecturas para los mensajes de consola
+ * @tparam T Tipo de dato de la lectura
+ * @return Cadena constante con el nombre del tipo
+ */
+template <typename T>
+constexpr const char* nombreTipoDato() {
+    if constexpr (std::is_same<T, float>::value) {
+        return "float";
+    } else if constexpr (std::is_same<T, double>::value) {
+        return "double";
+    } else {
+        return "int";
+    }
+}
+
+/**
+ * @brief Sensor concreto genérico
+ *
+ * Sustituye a las clases escritas a mano por tipo de sensor: el tipo de la
+ * lectura, la política de procesamiento y la etiqueta se fijan en tiempo de
+ * compilación, de modo que cada instanciación resuelve su procesamiento con
+ * `if constexpr` sin llamadas virtuales adicionales. La clase es final para
+ * que las llamadas a través de un puntero concreto se resuelvan estáticamente.
+ *
+ * Un tipo nuevo de sensor necesita la etiqueta en TipoSensor y su fila en
+ * rasgosTipoSensor() (SensorBase.h), el alias con su instanciación
+ * explícita, por ejemplo:
+ * @code
+ * using SensorHumedad = SensorTipado<float, PoliticaPromedio, TipoSensor::HUMEDAD>;
+ * @endcode
+ * y su fila en la tabla de FabricaSensores.cpp. El alta, la conversión de
+ * lecturas y la búsqueda por texto (manifiesto, ingesta, reglas y menú)
+ * pasan por esa tabla.
+ *
+ * @tparam T Tipo de dato de las lecturas (int, float, double)
+ * @tparam Politica Política de procesamiento (PoliticaPromedio, PoliticaDescartarMinimo)
+ * @tparam Tipo Etiqueta del tipo de sensor
+ */
+template <typename T, typename Politica, TipoSensor Tipo>
+class SensorTipado final : public SensorBase {
+public:
+    using Lectura = T;  ///< Tipo de dato de las lecturas
+
+private:
+    static const int TAM_TRAMO_CONVERSION = 256;  ///< Lecturas convertidas por tramo en la pila
+
+    ListaSensor<T> historial;  ///< Lista de lecturas del sensor
+
+public:
+    /**
+     * @brief Constructor por defecto
+     */
+    SensorTipado();
+
+    /**
+     * @brief Constructor con nombre del sensor
+     * @param nombreSensor Nombre identificador del sensor
+     */
+    SensorTipado(const char* nombreSensor);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~SensorTipado();
+
+    /**
+     * @brief Procesa las lecturas según la política del sensor
+     *
+     * Con PoliticaDescartarMinimo elimina la lectura más baja y calcula el
+     * promedio de las restantes; con PoliticaPromedio calcula el promedio
+     * de todas las lecturas
+     */
+    virtual void procesarLectura() override;
+
+    /**
+     * @brief Imprime la información del sensor
+     */
+    virtual void imprimirInfo() const override;
+
+    /**
+     * @brief Identifica el tipo de sensor
+     * @return Etiqueta Tipo de la instanciación
+     */
+    virtual TipoSensor obtenerTipo() const override;
+
+    /**
+     * @brief Estimadores en flujo de las lecturas ingeridas
+     * @return Referencia constante a las estadísticas del historial
+     */
+    virtual const EstadisticaFlujo& obtenerEstadisticas() const override;
+
+    /**
+     * @brief Activa el almacenamiento comprimido del historial
+     * @param lecturasPorBloque Lecturas por bloque sellado (0 lo deshabilita)
+     */
+    virtual void habilitarCompresion(int lecturasPorBloque) override;
+
+    /**
+     * @brief Memoria ocupada por el historial
+     * @return Bytes ocupados por nodos y bloques comprimidos
+     */
+    virtual std::size_t memoriaHistorial() const override;
+
+    /**
+     * @brief Activa el índice de valores del historial
+     * @param minimoDenso Primer valor del dominio denso (solo lecturas enteras)
+     * @param maximoDenso Último valor del dominio denso
+     */
+    virtual void habilitarIndice(long long minimoDenso, long long maximoDenso) override;
+
+    /**
+     * @brief Reserva de antemano los nodos del historial
+     * @param lecturas Lecturas que se espera recibir
+     */
+    virtual void reservarLecturas(int lecturas) override;
+
+    /**
+     * @brief Registra un lote de lecturas con una sola reserva de nodos
+     *
+     * Convierte las lecturas a T con convertir() en tramos de
+     * TAM_TRAMO_CONVERSION sobre la pila, sin reservar memoria por lote; los
+     * lectores ven el lote tramo a tramo. Una sola lectura se registra con
+     * registrarLectura().
+     *
+     * @param valores Lecturas en orden de llegada
+     * @param aceptadas Recibe las lecturas registradas ya convertidas
+     * @return Número de lecturas registradas
+     */
+    virtual int registrarLecturas(std::span<const double> valores, double* aceptadas) override;
+
+    /**
+     * @brief Registra un lote de lecturas ya convertidas a T
+     * @param valores Lecturas en orden de llegada
+     */
+    void registrarLecturas(std::span<const T> valores);
+
+    /**
+     * @brief Vuelca una instantánea del historial al exportador
+     * @param exportador Exportador abierto
+     */
+    virtual void exportar(ExportadorHistorial& exportador) const override;
+
+    /**
+     * @brief Registra una nueva lectura
+     * @param valor Valor a registrar
+     */
+    void registrarLectura(T valor);
+
+    /**
+     * @brief Convierte una lectura recibida como double al tipo del sensor
+     *
+     * Rechaza los valores no finitos y los que no caben en T; para T entero
+     * redondea al entero más cercano antes de comprobar el rango.
+     *
+     * @param valor Lectura recibida
+     * @param lectura Recibe el valor convertido
+     * @return true si el valor es válido para el sensor
+     */
+    static bool convertir(double valor, T& lectura);
+
+    /**
+     * @brief Obtiene el número de lecturas registradas
+     * @return Número de lecturas en el historial
+     */
+    int obtenerNumeroLecturas() const;
+
+    /**
+     * @brief Verifica si el sensor tiene lecturas registradas
+     * @return true si hay lecturas, false en caso contrario
+     */
+    bool tieneLecturas() const;
+
+    /**
+     * @brief Muestra todas las lecturas registradas
+     */
+    virtual void mostrarHistorial() const override;
+};
+
+// Implementación de métodos template
+
+template <typename T, typename Politica, TipoSensor Tipo>
+SensorTipado<T, Politica, Tipo>::SensorTipado() : SensorBase(rasgosTipoSensor(Tipo).nombrePorDefecto) {
+    std::cout << "[Log] " << rasgosTipoSensor(Tipo).clase << " creado: " << nombre << std::endl;
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+SensorTipado<T, Politica, Tipo>::SensorTipado(const char* nombreSensor) : SensorBase(nombreSensor) {
+    std::cout << "[Log] " << rasgosTipoSensor(Tipo).clase << " creado: " << nombre << std::endl;
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+SensorTipado<T, Politica, Tipo>::~SensorTipado() {
+    std::cout << "[Destructor Sensor " << nombre << "] Liberando Lista Interna..." << std::endl;
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+void SensorTipado<T, Politica, Tipo>::procesarLectura() {
+    std::cout << "-> Procesando Sensor " << nombre << "..." << std::endl;
+
+    ResultadoProcesamiento resultado = {true, historial.obtenerTamano(), 0.0, false, 0.0};
+    if (historial.estaVacia()) {
+        std::cout << "[Sensor " << rasgosTipoSensor(Tipo).etiqueta << "] No hay lecturas para procesar." << std::endl;
+        ultimoProcesamiento = resultado;
+        return;
+    }
+
+    int numLecturas = resultado.lecturas;
+
+    if constexpr (Politica::descartarMinimo) {
+        if (numLecturas == 1) {
+            T promedio = historial.calcularPromedio();
+            std::cout << "[Sensor " << rasgosTipoSensor(Tipo).etiqueta << "] Promedio calculado sobre "
+                      << numLecturas << " lectura (" << promedio << ")." << std::endl;
+            resultado.promedio = promedio;
+            ultimoProcesamiento = resultado;
+            return;
+        }
+
+        // Eliminar el valor mínimo y calcular promedio de los restantes
+        T minimo = historial.eliminarMinimo();
+        T promedio = historial.calcularPromedio();
+        std::cout << "[" << nombre << "] (" << rasgosTipoSensor(Tipo).etiquetaLectura << "): Lectura más baja ("
+                  << minimo << ") eliminada. Promedio restante: " << promedio << "." << std::endl;
+        resultado.promedio = promedio;
+        resultado.minimoDescartado = true;
+        resultado.minimo = minimo;
+    } else {
+        T promedio = historial.calcularPromedio();
+        std::cout << "[" << nombre << "] (" << rasgosTipoSensor(Tipo).etiquetaLectura << "): Promedio de lecturas: "
+                  << promedio << " (sobre " << numLecturas << " lecturas)." << std::endl;
+        resultado.promedio = promedio;
+    }
+    ultimoProcesamiento = resultado;
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+void SensorTipado<T, Politica, Tipo>::imprimirInfo() const {
+    std::cout << "=== Información del Sensor de " << nombreTipoSensor(Tipo) << " ===" << std::endl;
+    std::cout << "Nombre: " << nombre << std::endl;
+    std::cout << "Tipo: " << nombreTipoSensor(Tipo) << " (" << nombreTipoDato<T>() << ")" << std::endl;
+    std::cout << "Lecturas registradas: " << historial.obtenerTamano() << std::endl;
+
+    if (!historial.estaVacia()) {
+        std::cout << "Promedio actual: " << historial.calcularPromedio() << std::endl;
+    }
+    std::cout << "Memoria del historial: " << historial.memoriaResidente() << " bytes";
+    if (historial.obtenerLecturasPorBloque() > 0) {
+        std::cout << " (comprimido, bloques de " << historial.obtenerLecturasPorBloque() << ")";
+    }
+    std::cout << std::endl;
+
+    if (ultimoProcesamiento.procesado) {
+        std::cout << "Último procesamiento: ";
+        if (ultimoProcesamiento.lecturas == 0) {
+            std::cout << "sin lecturas";
+        } else {
+            std::cout << "promedio " << ultimoProcesamiento.promedio << " sobre "
+                      << ultimoProcesamiento.lecturas << " lectura(s)";
+            if (ultimoProcesamiento.minimoDescartado) {
+                std::cout << ", mínimo " << ultimoProcesamiento.minimo << " eliminado";
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    EstadisticaFlujo estadisticas = historial.obtenerInstantaneaEstadisticas();
+    if (estadisticas.obtenerCantidad() > 0) {
+        std::cout << "Desviación estándar: " << estadisticas.obtenerDesviacion() << std::endl;
+        std::cout << "p50/p95/p99: " << estadisticas.cuantil(0.50) << " / "
+                  << estadisticas.cuantil(0.95) << " / " << estadisticas.cuantil(0.99) << std::endl;
+    }
+    std::cout << rasgosTipoSensor(Tipo).cierreInfo << std::endl;
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+TipoSensor SensorTipado<T, Politica, Tipo>::obtenerTipo() const {
+    return Tipo;
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+const EstadisticaFlujo& SensorTipado<T, Politica, Tipo>::obtenerEstadisticas() const {
+    return historial.obtenerEstadisticas();
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+void SensorTipado<T, Politica, Tipo>::habilitarCompresion(int lecturasPorBloque) {
+    historial.habilitarCompresion(lecturasPorBloque);
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+std::size_t SensorTipado<T, Politica, Tipo>::memoriaHistorial() const {
+    return historial.memoriaResidente();
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+void SensorTipado<T, Politica, Tipo>::habilitarIndice(long long minimoDenso, long long maximoDenso) {
+    historial.habilitarIndice(minimoDenso, maximoDenso);
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+void SensorTipado<T, Politica, Tipo>::reservarLecturas(int lecturas) {
+    historial.reservarLecturas(lecturas);
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+void SensorTipado<T, Politica, Tipo>::registrarLectura(T valor) {
+    historial.insertar(valor);
+    std::cout << "[Log] Insertando Nodo<" << nombreTipoDato<T>() << "> en " << nombre << "." << std::endl;
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+bool SensorTipado<T, Politica, Tipo>::convertir(double valor, T& lectura) {
+    if (!std::isfinite(valor)) {
+        return false;
+    }
+
+    if constexpr (std::is_integral<T>::value) {
+        double redondeado = std::round(valor);
+        // 2^digits es el primer valor que no cabe en T (y es exacto en double)
+        if (redondeado < static_cast<double>(std::numeric_limits<T>::min()) ||
+            redondeado >= std::ldexp(1.0, std::numeric_limits<T>::digits)) {
+            return false;
+        }
+        lectura = static_cast<T>(redondeado);
+    } else {
+        if (std::fabs(valor) > static_cast<double>(std::numeric_limits<T>::max())) {
+            return false;
+        }
+        lectura = static_cast<T>(valor);
+    }
+    return true;
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+int SensorTipado<T, Politica, Tipo>::registrarLecturas(std::span<const double> valores, double* aceptadas) {
+    T lectura;
+    if (valores.size() == 1) {
+        if (!convertir(valores[0], lectura)) {
+            return 0;
+        }
+        registrarLectura(lectura);
+        aceptadas[0] = static_cast<double>(lectura);
+        return 1;
+    }
+
+    T convertidos[TAM_TRAMO_CONVERSION];
+    int pendientes = 0;
+    int numAceptadas = 0;
+    for (double valor : valores) {
+        if (!convertir(valor, lectura)) {
+            continue;
+        }
+        convertidos[pendientes++] = lectura;
+        aceptadas[numAceptadas++] = static_cast<double>(lectura);
+        if (pendientes == TAM_TRAMO_CONVERSION) {
+            historial.insertarLote(convertidos, pendientes);
+            pendientes = 0;
+        }
+    }
+    if (pendientes > 0) {
+        historial.insertarLote(convertidos, pendientes);
+    }
+    if (numAceptadas > 0) {
+        std::cout << "[Log] Insertando " << numAceptadas << " Nodo<" << nombreTipoDato<T>() << "> en " << nombre << "." << std::endl;
+    }
+    return numAceptadas;
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+void SensorTipado<T, Politica, Tipo>::registrarLecturas(std::span<const T> valores) {
+    if (valores.empty()) {
+        return;
+    }
+
+    int cantidad = static_cast<int>(valores.size());
+    historial.insertarLote(valores.data(), cantidad);
+    std::cout << "[Log] Insertando " << cantidad << " Nodo<" << nombreTipoDato<T>() << "> en " << nombre << "." << std::endl;
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+void SensorTipado<T, Politica, Tipo>::exportar(ExportadorHistorial& exportador) const {
+    historial.recorrerInstantanea(
+        [&](int cantidad) {
+            exportador.comenzarSensor(nombre, Tipo, static_cast<int>(sizeof(T)),
+                                      std::is_floating_point<T>::value, cantidad);
+        },
+        [&](const T& valor) { exportador.agregar(valor); });
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+int SensorTipado<T, Politica, Tipo>::obtenerNumeroLecturas() const {
+    return historial.obtenerTamano();
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+bool SensorTipado<T, Politica, Tipo>::tieneLecturas() const {
+    return !historial.estaVacia();
+}
+
+template <typename T, typename Politica, TipoSensor Tipo>
+void SensorTipado<T, Politica, Tipo>::mostrarHistorial() const {
+    std::cout << "Historial de " << nombre << ": ";
+    historial.imprimir();
+}
+
+#endif // SENSOR_TIPADO_H
@@ -0,0 +1,301 @@
+/**
+ * @file BucleEventos.cpp
+ * @brief Implementación del bucle de eventos con corrutinas
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#include "../include/BucleEventos.h"
+#include "../include/Reloj.h"
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Eventos de epoll atendidos por vuelta
+ */
+const int MAX_EVENTOS = 32;
+
+/**
+ * @brief Agrega un elemento al final de un arreglo que crece al doble
+ * @tparam E Tipo de elemento
+ * @param arreglo Arreglo (se reemplaza al crecer)
+ * @param cantidad Elementos ocupados (se incrementa)
+ * @param capacidad Elementos reservados
+ * @param elemento Elemento a agregar
+ */
+template <typename E>
+void agregarAlFinal(E*& arreglo, int& cantidad, int& capacidad, const E& elemento) {
+    if (cantidad == capacidad) {
+        int nuevaCapacidad = capacidad > 0 ? capacidad * 2 : 8;
+        E* nuevo = new E[nuevaCapacidad];
+        for (int i = 0; i < cantidad; i++) {
+            nuevo[i] = arreglo[i];
+        }
+        delete[] arreglo;
+        arreglo = nuevo;
+        capacidad = nuevaCapacidad;
+    }
+    arreglo[cantidad++] = elemento;
+}
+
+} // namespace
+
+BucleEventos::BucleEventos()
+    : epoll(-1), senales(-1), senalRecibida(0), detenido(false), esperas(nullptr), numEsperas(0), capacidadEsperas(0),
+      temporizadores(nullptr), numTemporizadores(0), capacidadTemporizadores(0),
+      listas(nullptr), numListas(0), capacidadListas(0) {
+#ifdef __linux__
+    epoll = epoll_create1(EPOLL_CLOEXEC);
+#endif
+}
+
+BucleEventos::~BucleEventos() {
+    // Las tareas suspendidas no volverán a reanudarse: se liberan sus marcos
+    for (int i = 0; i < numEsperas; i++) {
+        esperas[i].tarea.destroy();
+    }
+    for (int i = 0; i < numTemporizadores; i++) {
+        temporizadores[i].tarea.destroy();
+    }
+    for (int i = 0; i < numListas; i++) {
+        listas[i].destroy();
+    }
+    delete[] esperas;
+    delete[] temporizadores;
+    delete[] listas;
+#ifdef __linux__
+    if (senales >= 0) {
+        close(senales);
+        sigset_t conjunto;
+        sigemptyset(&conjunto);
+        sigaddset(&conjunto, SIGINT);
+        sigaddset(&conjunto, SIGTERM);
+        pthread_sigmask(SIG_UNBLOCK, &conjunto, nullptr);
+    }
+    if (epoll >= 0) {
+        close(epoll);
+    }
+#endif
+}
+
+bool BucleEventos::estaDisponible() const {
+    return epoll >= 0;
+}
+
+void BucleEventos::ejecutar() {
+    detenido = false;
+    while (!detenido && numEsperas + numTemporizadores + numListas > 0) {
+        // Sin tareas listas se duerme hasta el primer plazo (o indefinidamente)
+        int espera = -1;
+        if (numListas > 0) {
+            espera = 0;
+        } else if (numTemporizadores > 0) {
+            double primero = temporizadores[0].vence;
+            for (int i = 1; i < numTemporizadores; i++) {
+                if (temporizadores[i].vence < primero) {
+                    primero = temporizadores[i].vence;
+                }
+            }
+            double restante = primero - segundosMonotonicos();
+            espera = restante > 0.0 ? static_cast<int>(restante * 1000.0) + 1 : 0;
+        }
+        atenderEventos(espera);
+
+        // Solo se reanudan las tareas ya encoladas; las que se encolen ahora esperan a la próxima vuelta
+        int pendientes = numListas;
+        for (int i = 0; i < pendientes && !detenido; i++) {
+            std::coroutine_handle<> tarea = listas[i];
+            listas[i] = nullptr;
+            tarea.resume();
+        }
+        int quedan = 0;
+        for (int i = 0; i < numListas; i++) {
+            if (listas[i]) {
+                listas[quedan++] = listas[i];
+            }
+        }
+        numListas = quedan;
+    }
+}
+
+void BucleEventos::detener() {
+    detenido = true;
+}
+
+bool BucleEventos::detenerConSenales() {
+#ifdef __linux__
+    if (senales >= 0) {
+        return true;
+    }
+    if (epoll < 0) {
+        return false;
+    }
+    sigset_t conjunto;
+    sigemptyset(&conjunto);
+    sigaddset(&conjunto, SIGINT);
+    sigaddset(&conjunto, SIGTERM);
+    if (pthread_sigmask(SIG_BLOCK, &conjunto, nullptr) != 0) {
+        return false;
+    }
+    senales = signalfd(-1, &conjunto, SFD_NONBLOCK | SFD_CLOEXEC);
+    epoll_event evento;
+    std::memset(&evento, 0, sizeof(evento));
+    evento.events = EPOLLIN;
+    evento.data.fd = senales;
+    if (senales < 0 || epoll_ctl(epoll, EPOLL_CTL_ADD, senales, &evento) != 0) {
+        if (senales >= 0) {
+            close(senales);
+            senales = -1;
+        }
+        pthread_sigmask(SIG_UNBLOCK, &conjunto, nullptr);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+int BucleEventos::obtenerSenalRecibida() const {
+    return senalRecibida;
+}
+
+void BucleEventos::registrarLectura(int fd, std::coroutine_handle<> tarea) {
+#ifdef __linux__
+    epoll_event evento;
+    std::memset(&evento, 0, sizeof(evento));
+    evento.events = EPOLLIN;
+    evento.data.fd = fd;
+    if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &evento) == 0) {
+        EsperaDescriptor espera = {fd, tarea};
+        agregarAlFinal(esperas, numEsperas, capacidadEsperas, espera);
+        return;
+    }
+#endif
+    // Archivos regulares (EPERM) o descriptores inválidos: la lectura no bloquea
+    // (o falla de inmediato), así que la tarea solo cede el turno
+    (void)fd;
+    encolar(tarea);
+}
+
+void BucleEventos::registrarTemporizador(double segundos, std::coroutine_handle<> tarea) {
+    Temporizador temporizador = {segundosMonotonicos() + segundos, tarea};
+    agregarAlFinal(temporizadores, numTemporizadores, capacidadTemporizadores, temporizador);
+}
+
+void BucleEventos::encolar(std::coroutine_handle<> tarea) {
+    agregarAlFinal(listas, numListas, capacidadListas, tarea);
+}
+
+void BucleEventos::atenderEventos(int espera) {
+#ifdef __linux__
+    epoll_event eventos[MAX_EVENTOS];
+    int listos = numEsperas > 0 || espera != 0 ? epoll_wait(epoll, eventos, MAX_EVENTOS, espera) : 0;
+    for (int e = 0; e < listos; e++) {
+        int fd = eventos[e].data.fd;
+        if (fd == senales) {
+            signalfd_siginfo info;
+            while (read(senales, &info, sizeof(info)) == static_cast<ssize_t>(sizeof(info))) {
+                senalRecibida = static_cast<int>(info.ssi_signo);
+                detenido = true;
+            }
+            continue;
+        }
+        for (int i = 0; i < numEsperas; i++) {
+            if (esperas[i].fd == fd) {
+                epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+                encolar(esperas[i].tarea);
+                esperas[i] = esperas[--numEsperas];
+                break;
+            }
+        }
+    }
+#else
+    (void)espera;
+#endif
+
+    double ahora = segundosMonotonicos();
+    for (int i = 0; i < numTemporizadores;) {
+        if (temporizadores[i].vence <= ahora) {
+            encolar(temporizadores[i].tarea);
+            temporizadores[i] = temporizadores[--numTemporizadores];
+        } else {
+            i++;
+        }
+    }
+}
+
+LectorLineas::LectorLineas(int fd) : fd(fd), inicio(0), fin(0), descartando(false), cerrado(false) {
+}
+
+bool LectorLineas::llenar() {
+    if (cerrado) {
+        return false;
+    }
+    if (inicio > 0) {
+        std::memmove(bufer, bufer + inicio, fin - inicio);
+        fin -= inicio;
+        inicio = 0;
+    }
+    if (fin == TAM_BUFER) {
+        // Línea sin salto que no cabe: se descarta hasta el próximo salto
+        descartando = true;
+        fin = 0;
+    }
+
+#ifdef __linux__
+    ssize_t leidos = read(fd, bufer + fin, TAM_BUFER - fin);
+    if (leidos > 0) {
+        fin += static_cast<std::size_t>(leidos);
+        return true;
+    }
+    if (leidos < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return true;
+    }
+#endif
+    cerrado = true;
+    return false;
+}
+
+char* LectorLineas::siguienteLinea(std::size_t& largo) {
+    for (;;) {
+        char* salto = static_cast<char*>(std::memchr(bufer + inicio, '\n', fin - inicio));
+        if (salto == nullptr) {
+            if (descartando) {
+                inicio = fin = 0;
+                return nullptr;
+            }
+            if (cerrado && fin > inicio) {
+                // Última línea sin salto
+                char* linea = bufer + inicio;
+                largo = fin - inicio;
+                bufer[fin] = '\0';
+                inicio = fin;
+                return linea;
+            }
+            return nullptr;
+        }
+
+        char* linea = bufer + inicio;
+        inicio = static_cast<std::size_t>(salto - bufer) + 1;
+        if (descartando) {
+            descartando = false;
+            continue;
+        }
+        *salto = '\0';
+        largo = static_cast<std::size_t>(salto - linea);
+        if (largo > 0 && linea[largo - 1] == '\r') {
+            linea[--largo] = '\0';
+        }
+        return linea;
+    }
+}
@@ -0,0 +1,46 @@
+/**
+ * @file ColaAlertas.cpp
+ * @brief Implementación de la cola de alertas sin bloqueos
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#include "../include/ColaAlertas.h"
+
+ColaAlertas::ColaAlertas(unsigned int capacidad) : cola(0), cabeza(0), descartadas(0) {
+    unsigned int tamano = 2;
+    while (tamano < capacidad) {
+        tamano *= 2;
+    }
+    anillo = new Alerta[tamano];
+    mascara = tamano - 1;
+}
+
+ColaAlertas::~ColaAlertas() {
+    delete[] anillo;
+}
+
+bool ColaAlertas::publicar(const Alerta& alerta) {
+    unsigned int posicion = cola.load(std::memory_order_relaxed);
+    if (posicion - cabeza.load(std::memory_order_acquire) > mascara) {
+        descartadas.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    anillo[posicion & mascara] = alerta;
+    cola.store(posicion + 1, std::memory_order_release);
+    return true;
+}
+
+bool ColaAlertas::extraer(Alerta& alerta) {
+    unsigned int posicion = cabeza.load(std::memory_order_relaxed);
+    if (posicion == cola.load(std::memory_order_acquire)) {
+        return false;
+    }
+    alerta = anillo[posicion & mascara];
+    cabeza.store(posicion + 1, std::memory_order_release);
+    return true;
+}
+
+long long ColaAlertas::obtenerDescartadas() const {
+    return descartadas.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,138 @@
+/**
+ * @file ExportadorHistorial.cpp
+ * @brief Implementación del volcado de historiales a archivo
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#include "../include/ExportadorHistorial.h"
+
+namespace {
+
+/**
+ * @brief Magia del formato binario (incluye el terminador nulo)
+ */
+const char MAGIA_BINARIO[8] = "SIOTHIS";
+
+} // namespace
+
+ExportadorHistorial::ExportadorHistorial()
+    : archivo(nullptr), formato(FormatoExportacion::CSV), bufer(nullptr), ocupado(0),
+      bytesEscritos(0), lecturasEscritas(0), error(false), tamPrefijo(0), indice(0) {
+    prefijo[0] = '\0';
+}
+
+ExportadorHistorial::~ExportadorHistorial() {
+    cerrar();
+    delete[] bufer;
+}
+
+bool ExportadorHistorial::abrir(const char* ruta, FormatoExportacion formato) {
+    cerrar();
+
+    archivo = std::fopen(ruta, formato == FormatoExportacion::BINARIO ? "wb" : "w");
+    if (archivo == nullptr) {
+        return false;
+    }
+    // El búfer propio ya agrupa las escrituras: stdio las entrega tal cual
+    std::setvbuf(archivo, nullptr, _IONBF, 0);
+    if (bufer == nullptr) {
+        bufer = new char[TAM_BUFER];
+    }
+
+    this->formato = formato;
+    ocupado = 0;
+    bytesEscritos = 0;
+    lecturasEscritas = 0;
+    error = false;
+
+    if (formato == FormatoExportacion::BINARIO) {
+        std::memcpy(bufer, MAGIA_BINARIO, sizeof(MAGIA_BINARIO));
+        ocupado = sizeof(MAGIA_BINARIO);
+        escribirEntero(VERSION, 4);
+    } else {
+        const char encabezado[] = "sensor,tipo,indice,valor\n";
+        std::memcpy(bufer, encabezado, sizeof(encabezado) - 1);
+        ocupado = sizeof(encabezado) - 1;
+    }
+    return true;
+}
+
+bool ExportadorHistorial::cerrar() {
+    if (archivo == nullptr) {
+        return false;
+    }
+    vaciar();
+    if (std::fclose(archivo) != 0) {
+        error = true;
+    }
+    archivo = nullptr;
+    return !error;
+}
+
+bool ExportadorHistorial::estaAbierto() const {
+    return archivo != nullptr;
+}
+
+void ExportadorHistorial::comenzarSensor(const char* nombre, TipoSensor tipo, int bytesLectura,
+                                         bool flotante, int cantidad) {
+    if (TAM_BUFER - ocupado < MAX_FILA) {
+        vaciar();
+    }
+    indice = 0;
+
+    if (formato == FormatoExportacion::BINARIO) {
+        std::memset(bufer + ocupado, 0, TAM_NOMBRE_SENSOR);
+        std::strncpy(bufer + ocupado, nombre, TAM_NOMBRE_SENSOR - 1);
+        ocupado += TAM_NOMBRE_SENSOR;
+        escribirEntero(static_cast<std::uint64_t>(tipo), 1);
+        escribirEntero(static_cast<std::uint64_t>(bytesLectura), 1);
+        escribirEntero(flotante ? 1 : 0, 1);
+        escribirEntero(0, 1);
+        escribirEntero(static_cast<std::uint64_t>(cantidad), 8);
+        return;
+    }
+
+    // La fila CSV empieza siempre con "sensor,tipo,"; un nombre con separadores
+    // va entre comillas, con sus comillas duplicadas (RFC 4180)
+    std::size_t largoNombre = std::strlen(nombre);
+    tamPrefijo = 0;
+    if (std::strpbrk(nombre, ",\"\r\n") != nullptr) {
+        prefijo[tamPrefijo++] = '"';
+        for (std::size_t i = 0; i < largoNombre; i++) {
+            if (nombre[i] == '"') {
+                prefijo[tamPrefijo++] = '"';
+            }
+            prefijo[tamPrefijo++] = nombre[i];
+        }
+        prefijo[tamPrefijo++] = '"';
+    } else {
+        std::memcpy(prefijo, nombre, largoNombre);
+        tamPrefijo = largoNombre;
+    }
+    const char* nombreTipo = nombreTipoSensor(tipo);
+    std::size_t largoTipo = std::strlen(nombreTipo);
+    prefijo[tamPrefijo++] = ',';
+    std::memcpy(prefijo + tamPrefijo, nombreTipo, largoTipo);
+    tamPrefijo += largoTipo;
+    prefijo[tamPrefijo++] = ',';
+}
+
+unsigned long long ExportadorHistorial::obtenerBytesEscritos() const {
+    return bytesEscritos + ocupado;
+}
+
+unsigned long long ExportadorHistorial::obtenerLecturasEscritas() const {
+    return lecturasEscritas;
+}
+
+void ExportadorHistorial::vaciar() {
+    if (ocupado == 0) {
+        return;
+    }
+    if (std::fwrite(bufer, 1, ocupado, archivo) != ocupado) {
+        error = true;
+    }
+    bytesEscritos += ocupado;
+    ocupado = 0;
+}
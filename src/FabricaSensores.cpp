@@ -0,0 +1,123 @@
+/**
+ * @file FabricaSensores.cpp
+ * @brief Tabla de tipos de sensor: alta y conversión de lecturas
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#include "../include/FabricaSensores.h"
+#include "../include/SensorTemperatura.h"
+#include "../include/SensorPresion.h"
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Fila de la tabla de tipos de sensor
+ */
+struct EntradaFabrica {
+    TipoSensor tipo;                            ///< Etiqueta del tipo
+    SensorBase* (*crear)(const char*);          ///< Construye el sensor
+    bool (*convertir)(double, double&);         ///< Valida y convierte una lectura
+    const char* tipoLectura;                    ///< Nombre del tipo de dato de las lecturas
+};
+
+/**
+ * @brief Construye un sensor concreto
+ * @tparam Sensor Instanciación de SensorTipado
+ */
+template <typename Sensor>
+SensorBase* crear(const char* nombre) {
+    return new Sensor(nombre);
+}
+
+/**
+ * @brief Convierte con Sensor::convertir y devuelve el valor exacto como double
+ * @tparam Sensor Instanciación de SensorTipado
+ */
+template <typename Sensor>
+bool convertir(double valor, double& lectura) {
+    typename Sensor::Lectura convertida;
+    if (!Sensor::convertir(valor, convertida)) {
+        return false;
+    }
+    lectura = static_cast<double>(convertida);
+    return true;
+}
+
+/**
+ * @brief Fila de la tabla para una instanciación de SensorTipado
+ * @tparam Sensor Instanciación de SensorTipado
+ */
+template <typename Sensor>
+constexpr EntradaFabrica entrada(TipoSensor tipo) {
+    return {tipo, &crear<Sensor>, &convertir<Sensor>, nombreTipoDato<typename Sensor::Lectura>()};
+}
+
+/**
+ * @brief Un tipo nuevo de sensor se agrega con una fila aquí
+ */
+const EntradaFabrica TABLA_TIPOS[] = {
+    entrada<SensorTemperatura>(TipoSensor::TEMPERATURA),
+    entrada<SensorPresion>(TipoSensor::PRESION),
+};
+
+const int NUM_TIPOS = static_cast<int>(sizeof(TABLA_TIPOS) / sizeof(TABLA_TIPOS[0]));
+
+/**
+ * @brief Busca la fila de un tipo
+ * @param tipo Etiqueta del tipo
+ * @return Fila del tipo, o nullptr si no está en la tabla
+ */
+const EntradaFabrica* buscarEntrada(TipoSensor tipo) {
+    for (int i = 0; i < NUM_TIPOS; i++) {
+        if (TABLA_TIPOS[i].tipo == tipo) {
+            return &TABLA_TIPOS[i];
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+SensorBase* crearSensor(TipoSensor tipo, const char* nombre) {
+    const EntradaFabrica* fila = buscarEntrada(tipo);
+    return fila != nullptr ? fila->crear(nombre) : nullptr;
+}
+
+bool convertirLectura(TipoSensor tipo, double valor, double& lectura) {
+    const EntradaFabrica* fila = buscarEntrada(tipo);
+    return fila != nullptr && fila->convertir(valor, lectura);
+}
+
+const char* nombreTipoLectura(TipoSensor tipo) {
+    const EntradaFabrica* fila = buscarEntrada(tipo);
+    return fila != nullptr ? fila->tipoLectura : "?";
+}
+
+bool buscarTipoPorClave(const char* clave, TipoSensor& tipo) {
+    for (int i = 0; i < NUM_TIPOS; i++) {
+        if (std::strcmp(rasgosTipoSensor(TABLA_TIPOS[i].tipo).clave, clave) == 0) {
+            tipo = TABLA_TIPOS[i].tipo;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool buscarTipoPorPrefijo(const char* prefijo, std::size_t largo, TipoSensor& tipo) {
+    for (int i = 0; i < NUM_TIPOS; i++) {
+        const char* candidato = rasgosTipoSensor(TABLA_TIPOS[i].tipo).prefijoIngesta;
+        if (std::strlen(candidato) == largo && std::strncmp(candidato, prefijo, largo) == 0) {
+            tipo = TABLA_TIPOS[i].tipo;
+            return true;
+        }
+    }
+    return false;
+}
+
+void escribirClavesTipos(std::ostream& salida, const char* antes) {
+    for (int i = 0; i < NUM_TIPOS; i++) {
+        salida << (i > 0 ? "|" : "") << antes << rasgosTipoSensor(TABLA_TIPOS[i].tipo).clave;
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * @file GestorEpocas.cpp
+ * @brief Implementación de la recuperación de memoria basada en épocas
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#include "../include/GestorEpocas.h"
+#include <thread>
+
+namespace {
+
+/**
+ * @brief Estado por hilo: ranura asignada y profundidad de anidamiento
+ */
+struct HiloLector {
+    int ranura;       ///< Ranura en el gestor (-1 = sin asignar)
+    int profundidad;  ///< Secciones de lectura abiertas
+
+    HiloLector() : ranura(-1), profundidad(0) {}
+
+    ~HiloLector() {
+        if (ranura >= 0) {
+            GestorEpocas::global().liberarRanura(ranura);
+        }
+    }
+};
+
+thread_local HiloLector hiloLector;
+
+} // namespace
+
+GestorEpocas::GestorEpocas() : epoca(0) {
+    for (int i = 0; i < MAX_HILOS; i++) {
+        ranuras[i].estado.store(0);
+        ranuras[i].ocupada.store(false);
+    }
+}
+
+GestorEpocas& GestorEpocas::global() {
+    static GestorEpocas gestor;
+    return gestor;
+}
+
+void GestorEpocas::entrar() {
+    if (hiloLector.profundidad++ > 0) {
+        return;
+    }
+    if (hiloLector.ranura < 0) {
+        hiloLector.ranura = tomarRanura();
+    }
+    ranuras[hiloLector.ranura].estado.store((epoca.load() << 1) | ACTIVO);
+}
+
+void GestorEpocas::salir() {
+    if (--hiloLector.profundidad > 0) {
+        return;
+    }
+    ranuras[hiloLector.ranura].estado.store(0);
+}
+
+std::uint64_t GestorEpocas::epocaActual() const {
+    return epoca.load();
+}
+
+std::uint64_t GestorEpocas::intentarAvanzar() {
+    std::uint64_t actual = epoca.load();
+    for (int i = 0; i < MAX_HILOS; i++) {
+        std::uint64_t estado = ranuras[i].estado.load();
+        if ((estado & ACTIVO) != 0 && (estado >> 1) != actual) {
+            return actual;  // Un lector sigue en una época anterior
+        }
+    }
+    epoca.compare_exchange_strong(actual, actual + 1);
+    return epoca.load();
+}
+
+void GestorEpocas::sincronizar() {
+    std::uint64_t objetivo = epoca.load() + 2;
+    while (intentarAvanzar() < objetivo) {
+        std::this_thread::yield();
+    }
+}
+
+void GestorEpocas::liberarRanura(int ranura) {
+    ranuras[ranura].estado.store(0);
+    ranuras[ranura].ocupada.store(false);
+}
+
+int GestorEpocas::tomarRanura() {
+    for (;;) {
+        for (int i = 0; i < MAX_HILOS; i++) {
+            bool libre = false;
+            if (ranuras[i].ocupada.compare_exchange_strong(libre, true)) {
+                return i;
+            }
+        }
+        std::this_thread::yield();  // Más de MAX_HILOS lectores: esperar a que termine uno
+    }
+}
@@ -0,0 +1,118 @@
+/**
+ * @file LectorMemoria.cpp
+ * @brief Implementación del lector del segmento compartido de sensores
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#include "../include/LectorMemoria.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MEMORIA_COMPARTIDA_POSIX 1
+#endif
+
+LectorMemoria::LectorMemoria()
+    : mapeo(nullptr), tamano(0), ranuras(nullptr), numRanuras(0), pidEscritor(0) {
+}
+
+LectorMemoria::~LectorMemoria() {
+    cerrar();
+}
+
+bool LectorMemoria::abrir(const char* nombre) {
+    cerrar();
+
+#ifdef MEMORIA_COMPARTIDA_POSIX
+    int descriptor = shm_open(nombre, O_RDONLY, 0);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat informacion;
+    if (fstat(descriptor, &informacion) != 0 ||
+        static_cast<std::size_t>(informacion.st_size) < sizeof(EncabezadoSegmento)) {
+        close(descriptor);
+        return false;
+    }
+    std::size_t bytes = static_cast<std::size_t>(informacion.st_size);
+    void* memoria = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (memoria == MAP_FAILED) {
+        return false;
+    }
+
+    const EncabezadoSegmento* encabezado = static_cast<const EncabezadoSegmento*>(memoria);
+    bool compatible = encabezado->magia == EncabezadoSegmento::MAGIA;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    compatible = compatible && encabezado->version == EncabezadoSegmento::VERSION &&
+                 encabezado->lecturasRecientes == static_cast<std::uint32_t>(RanuraSensor::LECTURAS_RECIENTES) &&
+                 tamanoSegmento(encabezado->numRanuras) <= bytes;
+    if (!compatible) {
+        munmap(memoria, bytes);
+        return false;
+    }
+
+    mapeo = memoria;
+    tamano = bytes;
+    numRanuras = encabezado->numRanuras;
+    pidEscritor = encabezado->pidEscritor;
+    ranuras = reinterpret_cast<const RanuraSensor*>(static_cast<const unsigned char*>(memoria) + desplazamientoRanuras());
+    return true;
+#else
+    (void)nombre;
+    return false;
+#endif
+}
+
+void LectorMemoria::cerrar() {
+#ifdef MEMORIA_COMPARTIDA_POSIX
+    if (mapeo != nullptr) {
+        munmap(const_cast<void*>(mapeo), tamano);
+    }
+#endif
+    mapeo = nullptr;
+    tamano = 0;
+    ranuras = nullptr;
+    numRanuras = 0;
+    pidEscritor = 0;
+}
+
+int LectorMemoria::obtenerNumRanuras() const {
+    return static_cast<int>(numRanuras);
+}
+
+long long LectorMemoria::obtenerPidEscritor() const {
+    return pidEscritor;
+}
+
+bool LectorMemoria::leerEstadisticas(int ranura, EstadisticaPublicada& estadisticas) const {
+    if (ranura < 0 || static_cast<std::uint32_t>(ranura) >= numRanuras) {
+        return false;
+    }
+    const RanuraSensor& actual = ranuras[ranura];
+
+    std::uint32_t antes;
+    std::uint32_t despues;
+    do {
+        antes = actual.secuencia.load(std::memory_order_acquire);
+        std::memcpy(&estadisticas, &actual.estadisticas, sizeof(estadisticas));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        despues = actual.secuencia.load(std::memory_order_relaxed);
+    } while ((antes & 1u) != 0 || antes != despues);
+
+    return estadisticas.activa != 0;
+}
+
+int LectorMemoria::buscar(const char* nombre) const {
+    EstadisticaPublicada estadisticas;
+    for (std::uint32_t i = 0; i < numRanuras; i++) {
+        if (leerEstadisticas(static_cast<int>(i), estadisticas) &&
+            std::strncmp(estadisticas.nombre, nombre, TAM_NOMBRE_SENSOR) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
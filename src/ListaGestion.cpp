@@ -0,0 +1,567 @@
+/**
+ * @file ListaGestion.cpp
+ * @brief Implementación de la lista de gestión polimórfica de sensores
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#include "../include/ListaGestion.h"
+#include "../include/FabricaSensores.h"
+#include "../include/Reloj.h"
+#include "../include/MemoriaHistorial.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+/**
+ * @brief Predicado de inactividad usado por eliminarInactivos()
+ * @param resumen Fila a evaluar
+ * @param contexto Puntero a la marca de tiempo límite (double)
+ * @return true si la última lectura es anterior al límite
+ */
+bool esInactivo(const ResumenSensor& resumen, void* contexto) {
+    return resumen.ultimaLectura < *static_cast<double*>(contexto);
+}
+
+/**
+ * @brief Lecturas de un lote que se convierten y publican de una vez
+ */
+const int TAM_TRAMO_LOTE = 256;
+
+/**
+ * @brief Sensores a partir de los cuales las consultas de flota usan hilos
+ */
+const int MIN_FILAS_PARALELO = 8192;
+
+/**
+ * @brief Campos leídos por línea de manifiesto (tipo, nombre y opciones)
+ */
+const int MAX_CAMPOS_MANIFIESTO = 8;
+
+/**
+ * @brief Mayor reserva de lecturas aceptada por sensor en un manifiesto
+ */
+const long MAX_RESERVA_MANIFIESTO = 1L << 24;
+
+/**
+ * @brief Separa una línea en campos delimitados por espacios, en el lugar
+ * @param linea Línea a separar (se insertan terminadores nulos)
+ * @param campos Recibe el inicio de cada campo
+ * @param maximo Campos a lo sumo
+ * @return Número de campos (maximo + 1 si la línea tiene más)
+ */
+int separarCampos(char* linea, char** campos, int maximo) {
+    int numCampos = 0;
+    char* cursor = linea;
+    for (;;) {
+        while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r') {
+            cursor++;
+        }
+        if (*cursor == '\0') {
+            return numCampos;
+        }
+        if (numCampos == maximo) {
+            return maximo + 1;
+        }
+        campos[numCampos++] = cursor;
+        while (*cursor != '\0' && *cursor != ' ' && *cursor != '\t' && *cursor != '\r') {
+            cursor++;
+        }
+        if (*cursor != '\0') {
+            *cursor++ = '\0';
+        }
+    }
+}
+
+} // namespace
+
+ListaGestion::ListaGestion()
+    : lecturasPorBloque(0), indiceHabilitado(false), minimoIndice(0), maximoIndice(-1), hilos(nullptr) {
+    std::cout << "[Log] Lista de Gestión Polimórfica creada." << std::endl;
+}
+
+ListaGestion::~ListaGestion() {
+    std::cout << "\n--- Liberación de Memoria en Cascada ---" << std::endl;
+    const unsigned int* manejadores = registro.columnaManejadores();
+    for (int fila = 0; fila < registro.obtenerCantidad(); fila++) {
+        SensorBase* sensor = registro.obtenerSensor(manejadores[fila]);
+        std::cout << "[Destructor General] Liberando Nodo: "
+                  << sensor->obtenerNombre() << "." << std::endl;
+        delete sensor;  // Llama al destructor virtual apropiado
+    }
+    delete hilos;
+    std::cout << "Sistema cerrado. Memoria limpia." << std::endl;
+}
+
+bool ListaGestion::insertarSensor(SensorBase* sensor) {
+    if (darDeAlta(sensor, lecturasPorBloque) == RegistroColumnar::SIN_MANEJADOR) {
+        std::cout << "Error: Ya existe un sensor llamado '" << sensor->obtenerNombre()
+                  << "'." << std::endl;
+        return false;
+    }
+
+    std::cout << "Sensor '" << sensor->obtenerNombre()
+              << "' creado e insertado en la lista de gestión." << std::endl;
+    return true;
+}
+
+int ListaGestion::cargarManifiesto(const char* ruta) {
+    double inicio = segundosMonotonicos();
+
+    // Lectura completa del archivo en un solo búfer terminado en nulo
+    std::FILE* archivo = std::fopen(ruta, "rb");
+    if (archivo == nullptr) {
+        return -1;
+    }
+    std::fseek(archivo, 0, SEEK_END);
+    long tamano = std::ftell(archivo);
+    std::fseek(archivo, 0, SEEK_SET);
+    if (tamano < 0) {
+        std::fclose(archivo);
+        return -1;
+    }
+    char* texto = new char[tamano + 1];
+    std::size_t leidos = std::fread(texto, 1, static_cast<std::size_t>(tamano), archivo);
+    std::fclose(archivo);
+    texto[leidos] = '\0';
+
+    // Una fila por línea como cota: el registro y su índice crecen una sola vez
+    int lineas = 1;
+    for (std::size_t i = 0; i < leidos; i++) {
+        if (texto[i] == '\n') {
+            lineas++;
+        }
+    }
+    registro.reservar(registro.obtenerCantidad() + lineas);
+
+    int altas = 0;
+    int rechazadas = 0;
+    int numLinea = 0;
+    char* linea = texto;
+    while (linea != nullptr) {
+        numLinea++;
+        char* finLinea = std::strchr(linea, '\n');
+        if (finLinea != nullptr) {
+            *finLinea = '\0';
+        }
+
+        char* campos[MAX_CAMPOS_MANIFIESTO];
+        int numCampos = separarCampos(linea, campos, MAX_CAMPOS_MANIFIESTO);
+        linea = finLinea != nullptr ? finLinea + 1 : nullptr;
+        if (numCampos == 0 || campos[0][0] == '#') {
+            continue;
+        }
+
+        const char* error = nullptr;
+        TipoSensor tipo = TipoSensor::TEMPERATURA;
+        int compresion = lecturasPorBloque;
+        long reserva = 0;
+        if (numCampos > MAX_CAMPOS_MANIFIESTO) {
+            error = "demasiados campos";
+        } else if (numCampos < 2) {
+            error = "se esperaba 'tipo nombre'";
+        } else if (!buscarTipoPorClave(campos[0], tipo)) {
+            error = "tipo desconocido";
+        }
+        if (error == nullptr && std::strlen(campos[1]) >= static_cast<std::size_t>(TAM_NOMBRE_SENSOR)) {
+            error = "nombre demasiado largo";
+        }
+        for (int c = 2; error == nullptr && c < numCampos; c++) {
+            char* fin = nullptr;
+            if (std::strncmp(campos[c], "compresion=", 11) == 0) {
+                compresion = static_cast<int>(std::strtol(campos[c] + 11, &fin, 10));
+            } else if (std::strncmp(campos[c], "reserva=", 8) == 0) {
+                reserva = std::strtol(campos[c] + 8, &fin, 10);
+            }
+            if (fin == nullptr || *fin != '\0' || compresion < 0 || reserva < 0 || reserva > MAX_RESERVA_MANIFIESTO) {
+                error = "opción inválida";
+            }
+        }
+        if (error == nullptr && registro.buscar(campos[1]) != RegistroColumnar::SIN_MANEJADOR) {
+            error = "el sensor ya existe";
+        }
+        if (error != nullptr) {
+            std::cout << "Advertencia: Manifiesto línea " << numLinea << ": " << error << "." << std::endl;
+            rechazadas++;
+            continue;
+        }
+
+        // Los constructores registran cada paso en consola: se descarta durante el alta
+        std::streambuf* consola = std::cout.rdbuf(nullptr);
+        SensorBase* sensor = crearSensor(tipo, campos[1]);
+        darDeAlta(sensor, compresion);
+        if (reserva > 0) {
+            sensor->reservarLecturas(static_cast<int>(reserva));
+        }
+        std::cout.rdbuf(consola);
+        std::cout.clear();
+        altas++;
+    }
+    delete[] texto;
+
+    std::cout << "[Log] Manifiesto '" << ruta << "': " << altas << " sensores provisionados en "
+              << (segundosMonotonicos() - inicio) * 1000.0 << " ms";
+    if (rechazadas > 0) {
+        std::cout << " (" << rechazadas << " líneas rechazadas)";
+    }
+    std::cout << "." << std::endl;
+    return altas;
+}
+
+bool ListaGestion::habilitarPublicacion(const char* nombreSegmento, int numRanuras) {
+    if (numRanuras <= 0) {
+        numRanuras = registro.obtenerCapacidadManejadores();
+        if (numRanuras < PublicadorMemoria::RANURAS_POR_DEFECTO) {
+            numRanuras = PublicadorMemoria::RANURAS_POR_DEFECTO;
+        }
+    }
+    if (!publicador.abrir(nombreSegmento, numRanuras)) {
+        return false;
+    }
+
+    // Los sensores ya registrados se publican con su estado actual
+    const unsigned int* manejadores = registro.columnaManejadores();
+    const double* ultimasLecturas = registro.columnaUltimasLecturas();
+    for (int fila = 0; fila < registro.obtenerCantidad(); fila++) {
+        SensorBase* sensor = registro.obtenerSensor(manejadores[fila]);
+        publicador.publicarAlta(manejadores[fila], *sensor, ultimasLecturas[fila]);
+    }
+    return true;
+}
+
+void ListaGestion::establecerCompresion(int lecturasPorBloque) {
+    this->lecturasPorBloque = lecturasPorBloque;
+}
+
+void ListaGestion::establecerIndice(long long minimoDenso, long long maximoDenso) {
+    indiceHabilitado = true;
+    minimoIndice = minimoDenso;
+    maximoIndice = maximoDenso;
+}
+
+SensorBase* ListaGestion::buscarSensor(const char* nombre) const {
+    return registro.obtenerSensor(registro.buscar(nombre));
+}
+
+unsigned int ListaGestion::buscarId(const char* nombre) const {
+    return registro.buscar(nombre);
+}
+
+bool ListaGestion::eliminarSensor(const char* nombre) {
+    return liberarSensor(registro.buscar(nombre));
+}
+
+bool ListaGestion::eliminarSensor(unsigned int id) {
+    return liberarSensor(id);
+}
+
+int ListaGestion::eliminarSensoresSi(PredicadoSensor predicado, void* contexto) {
+    int eliminados = 0;
+
+    // Se recorre de la última fila hacia la primera: al eliminar, la fila que
+    // ocupa el hueco ya fue evaluada
+    for (int fila = registro.obtenerCantidad() - 1; fila >= 0; fila--) {
+        ResumenSensor resumen = registro.obtenerResumen(fila);
+        if (predicado(resumen, contexto)) {
+            liberarSensor(resumen.manejador);
+            eliminados++;
+        }
+    }
+    return eliminados;
+}
+
+int ListaGestion::eliminarInactivos(double segundos) {
+    double limite = segundosActuales() - segundos;
+    return eliminarSensoresSi(esInactivo, &limite);
+}
+
+unsigned int ListaGestion::darDeAlta(SensorBase* sensor, int lecturasPorBloque) {
+    double marcaTiempo = segundosActuales();
+    unsigned int manejador = registro.agregar(sensor, marcaTiempo);
+    if (manejador == RegistroColumnar::SIN_MANEJADOR) {
+        return manejador;
+    }
+
+    if (lecturasPorBloque > 0) {
+        sensor->habilitarCompresion(lecturasPorBloque);
+    }
+    if (indiceHabilitado) {
+        sensor->habilitarIndice(minimoIndice, maximoIndice);
+    }
+    if (publicador.estaAbierto()) {
+        publicador.publicarAlta(manejador, *sensor, marcaTiempo);
+    }
+    return manejador;
+}
+
+bool ListaGestion::liberarSensor(unsigned int id) {
+    SensorBase* sensor = registro.eliminar(id);
+    if (sensor == nullptr) {
+        return false;
+    }
+
+    std::cout << "[Baja] Liberando sensor: " << sensor->obtenerNombre() << "." << std::endl;
+    reglas.olvidarSensor(id);
+    if (publicador.estaAbierto()) {
+        publicador.publicarBaja(id);
+    }
+    delete sensor;  // Libera su historial de inmediato
+    return true;
+}
+
+bool ListaGestion::registrarLectura(const char* nombre, double valor) {
+    unsigned int manejador = registro.buscar(nombre);
+    SensorBase* sensor = registro.obtenerSensor(manejador);
+    if (sensor == nullptr) {
+        return false;
+    }
+    double marcaTiempo = segundosActuales();
+
+    // El sensor valida y convierte; el resto ve el valor ya convertido
+    double lectura;
+    if (sensor->registrarLecturas(std::span<const double>(&valor, 1), &lectura) == 0) {
+        return false;
+    }
+    registro.acumularLectura(manejador, lectura, marcaTiempo);
+    reglas.evaluar(manejador, sensor->obtenerTipo(), nombre, lectura, marcaTiempo);
+
+    if (publicador.estaAbierto()) {
+        publicador.publicarLecturas(manejador, *sensor, &lectura, 1, marcaTiempo);
+    }
+    return true;
+}
+
+int ListaGestion::registrarLecturas(const char* nombre, const double* valores, int cantidad) {
+    unsigned int manejador = registro.buscar(nombre);
+    SensorBase* sensor = registro.obtenerSensor(manejador);
+    if (sensor == nullptr) {
+        return -1;
+    }
+    if (cantidad <= 0) {
+        return 0;
+    }
+
+    // Una reserva de nodos por lote, una llamada virtual por tramo y una sola actualización de la fila
+    double marcaTiempo = segundosActuales();
+    TipoSensor tipo = sensor->obtenerTipo();
+    sensor->reservarLecturas(cantidad);
+
+    // El sensor convierte cada valor una vez; reglas y publicación reciben el mismo tramo convertido
+    double aceptadas[TAM_TRAMO_LOTE];
+    int registradas = 0;
+    for (int inicio = 0; inicio < cantidad; inicio += TAM_TRAMO_LOTE) {
+        int tramo = cantidad - inicio < TAM_TRAMO_LOTE ? cantidad - inicio : TAM_TRAMO_LOTE;
+        int numAceptadas = sensor->registrarLecturas(std::span<const double>(valores + inicio, tramo), aceptadas);
+        for (int i = 0; i < numAceptadas; i++) {
+            reglas.evaluar(manejador, tipo, sensor->obtenerNombre(), aceptadas[i], marcaTiempo);
+        }
+        if (publicador.estaAbierto() && numAceptadas > 0) {
+            publicador.publicarLecturas(manejador, *sensor, aceptadas, numAceptadas, marcaTiempo);
+        }
+        registradas += numAceptadas;
+    }
+    if (registradas > 0) {
+        registro.sincronizarFila(manejador, sensor->obtenerEstadisticas(), marcaTiempo);
+    }
+    return registradas;
+}
+
+bool ListaGestion::ingerirLinea(const char* linea) {
+    TipoSensor tipo;
+    const char* finPrefijo = std::strchr(linea, ':');
+    if (finPrefijo == nullptr ||
+        !buscarTipoPorPrefijo(linea, static_cast<std::size_t>(finPrefijo - linea), tipo)) {
+        return false;
+    }
+
+    const char* inicioNombre = finPrefijo + 1;
+    const char* separador = std::strchr(inicioNombre, ':');
+    std::size_t largoNombre = separador != nullptr ? static_cast<std::size_t>(separador - inicioNombre) : 0;
+    if (largoNombre == 0 || largoNombre >= static_cast<std::size_t>(TAM_NOMBRE_SENSOR)) {
+        return false;
+    }
+    char nombre[TAM_NOMBRE_SENSOR];
+    std::memcpy(nombre, inicioNombre, largoNombre);
+    nombre[largoNombre] = '\0';
+
+    // El valor se valida antes de dar de alta el sensor
+    char* fin = nullptr;
+    double valor = std::strtod(separador + 1, &fin);
+    double lectura;
+    if (fin == separador + 1 || *fin != '\0' || !convertirLectura(tipo, valor, lectura)) {
+        return false;
+    }
+
+    SensorBase* sensor = buscarSensor(nombre);
+    if (sensor == nullptr) {
+        insertarSensor(crearSensor(tipo, nombre));
+    } else if (sensor->obtenerTipo() != tipo) {
+        return false;
+    }
+    return registrarLectura(nombre, lectura);
+}
+
+int ListaGestion::agregarRegla(const char* especificacion) {
+    return reglas.agregarRegla(especificacion);
+}
+
+bool ListaGestion::eliminarRegla(int id) {
+    return reglas.eliminarRegla(id);
+}
+
+void ListaGestion::mostrarReglas() const {
+    std::cout << "\n--- Reglas de Alerta ---" << std::endl;
+    int activas = 0;
+    for (int id = 0; id < reglas.obtenerCantidad(); id++) {
+        const Regla* regla = reglas.obtenerRegla(id);
+        if (regla->activa) {
+            std::cout << "#" << id << ": ";
+            MotorReglas::describir(*regla, std::cout);
+            std::cout << std::endl;
+            activas++;
+        }
+    }
+    if (activas == 0) {
+        std::cout << "No hay reglas registradas." << std::endl;
+    }
+}
+
+int ListaGestion::atenderAlertas() {
+    ColaAlertas& alertas = reglas.obtenerAlertas();
+    Alerta alerta;
+    int atendidas = 0;
+    while (alertas.extraer(alerta)) {
+        std::cout << "[Alerta] Regla #" << alerta.regla << " (";
+        MotorReglas::describir(*reglas.obtenerRegla(alerta.regla), std::cout);
+        std::cout << ") en " << alerta.sensor << ": valor " << alerta.valor << "." << std::endl;
+        atendidas++;
+    }
+    return atendidas;
+}
+
+int ListaGestion::exportarHistoriales(const char* ruta, FormatoExportacion formato, const char* nombre) const {
+    SensorBase* unico = nullptr;
+    if (nombre != nullptr) {
+        unico = buscarSensor(nombre);
+        if (unico == nullptr) {
+            return -1;
+        }
+    }
+
+    ExportadorHistorial exportador;
+    if (!exportador.abrir(ruta, formato)) {
+        return -1;
+    }
+
+    int exportados = 0;
+    if (unico != nullptr) {
+        unico->exportar(exportador);
+        exportados = 1;
+    } else {
+        const unsigned int* manejadores = registro.columnaManejadores();
+        for (int fila = 0; fila < registro.obtenerCantidad(); fila++) {
+            registro.obtenerSensor(manejadores[fila])->exportar(exportador);
+            exportados++;
+        }
+    }
+
+    unsigned long long lecturas = exportador.obtenerLecturasEscritas();
+    if (!exportador.cerrar()) {
+        return -1;
+    }
+    std::cout << "[Log] Exportadas " << lecturas << " lecturas de " << exportados << " sensores a " << ruta
+              << " (" << exportador.obtenerBytesEscritos() << " bytes)." << std::endl;
+    return exportados;
+}
+
+void ListaGestion::ejecutarProcesamientoPolimorfico() {
+    if (registro.estaVacio()) {
+        std::cout << "No hay sensores registrados para procesar." << std::endl;
+        return;
+    }
+
+    std::cout << "\n--- Ejecutando Polimorfismo ---" << std::endl;
+    const unsigned int* manejadores = registro.columnaManejadores();
+    for (int fila = 0; fila < registro.obtenerCantidad(); fila++) {
+        registro.obtenerSensor(manejadores[fila])->procesarLectura();  // Llamada polimórfica
+        registro.marcarProcesado(manejadores[fila]);
+    }
+    registro.vaciarPendientes();
+}
+
+int ListaGestion::ejecutarProcesamientoIncremental() {
+    if (registro.estaVacio()) {
+        std::cout << "No hay sensores registrados para procesar." << std::endl;
+        return 0;
+    }
+
+    std::cout << "\n--- Ejecutando Polimorfismo (incremental) ---" << std::endl;
+    const unsigned int* pendientes = registro.listaPendientes();
+    int procesados = 0;
+    for (int i = 0; i < registro.obtenerNumPendientes(); i++) {
+        // Las entradas de sensores dados de baja o repetidas ya no están modificadas
+        if (registro.estaModificado(pendientes[i])) {
+            registro.obtenerSensor(pendientes[i])->procesarLectura();
+            registro.marcarProcesado(pendientes[i]);
+            procesados++;
+        }
+    }
+    registro.vaciarPendientes();
+
+    std::cout << "[Log] Procesamiento incremental: " << procesados << " de "
+              << registro.obtenerCantidad() << " sensores con datos nuevos." << std::endl;
+    return procesados;
+}
+
+bool ListaGestion::tieneLecturasNuevas() const {
+    return registro.obtenerNumPendientes() > 0;
+}
+
+void ListaGestion::mostrarTodosSensores() const {
+    if (registro.estaVacio()) {
+        std::cout << "No hay sensores registrados." << std::endl;
+        return;
+    }
+
+    std::cout << "\n--- Lista de Sensores Registrados ---" << std::endl;
+    const char (*nombres)[TAM_NOMBRE_SENSOR] = registro.columnaNombres();
+    const unsigned int* ids = registro.columnaManejadores();
+    for (int fila = 0; fila < registro.obtenerCantidad(); fila++) {
+        std::cout << fila + 1 << ". " << nombres[fila] << " (ID " << ids[fila] << ")" << std::endl;
+    }
+    std::cout << "Promedio de promedios: " << registro.promedioDePromedios() << std::endl;
+    if (MemoriaHistorial::global().estaHabilitado()) {
+        MemoriaHistorial::global().imprimirEstadisticas(std::cout);
+    }
+}
+
+double ListaGestion::promedioDePromedios() const {
+    return registro.promedioDePromedios();
+}
+
+AgregadoFlota ListaGestion::consultarFlota(const ConsultaFlota& consulta) const {
+    // Flotas pequeñas caben en un tramo: no vale la pena arrancar hilos
+    if (hilos == nullptr && registro.obtenerCantidad() > MIN_FILAS_PARALELO) {
+        hilos = new PoolHilos();
+    }
+    return registro.consultar(consulta, hilos);
+}
+
+AgregadoFlota ListaGestion::agregadoPorTipo(TipoSensor tipo) const {
+    ConsultaFlota consulta = {true, tipo, FiltroPromedio::NINGUNO, 0.0};
+    return consultarFlota(consulta);
+}
+
+int ListaGestion::contarSensoresConPromedio(TipoSensor tipo, FiltroPromedio filtro, double umbral) const {
+    ConsultaFlota consulta = {true, tipo, filtro, umbral};
+    return consultarFlota(consulta).sensores;
+}
+
+int ListaGestion::obtenerCantidad() const {
+    return registro.obtenerCantidad();
+}
+
+bool ListaGestion::estaVacia() const {
+    return registro.estaVacio();
+}
@@ -0,0 +1,286 @@
+/**
+ * @file MemoriaHistorial.cpp
+ * @brief Implementación del respaldo de memoria de historiales
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#include "../include/MemoriaHistorial.h"
+#include <cstdio>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+/**
+ * @brief Política MPOL_BIND de mbind(2) (evita depender de libnuma)
+ */
+const int POLITICA_ENLAZAR = 2;
+
+/**
+ * @brief Cuenta los nodos NUMA en línea a partir de sysfs
+ * @param maximo Límite de nodos a considerar
+ * @return Número de nodos (al menos 1)
+ */
+int detectarNodos(int maximo) {
+    std::FILE* archivo = std::fopen("/sys/devices/system/node/online", "r");
+    if (archivo == nullptr) {
+        return 1;
+    }
+    // Formato de lista: "0", "0-1", "0,2-3"; interesa el índice más alto
+    int mayor = 0;
+    int valor = 0;
+    bool enNumero = false;
+    for (int c = std::fgetc(archivo); c != EOF; c = std::fgetc(archivo)) {
+        if (c >= '0' && c <= '9') {
+            valor = valor * 10 + (c - '0');
+            enNumero = true;
+        } else if (enNumero) {
+            if (valor > mayor) {
+                mayor = valor;
+            }
+            valor = 0;
+            enNumero = false;
+        }
+    }
+    if (enNumero && valor > mayor) {
+        mayor = valor;
+    }
+    std::fclose(archivo);
+    return mayor + 1 < maximo ? mayor + 1 : maximo;
+}
+#endif
+
+} // namespace
+
+MemoriaHistorial& MemoriaHistorial::global() {
+    static MemoriaHistorial respaldo;
+    return respaldo;
+}
+
+MemoriaHistorial::MemoriaHistorial()
+    : habilitado(false), paginasGrandes(false), numNodos(1),
+      reservasLocales(0), reservasRemotas(0), regionesGrandes(0), regionesAconsejadas(0),
+      regionesNormales(0), enlacesFallidos(0), bytesRegiones(0) {
+#ifdef __linux__
+    numNodos = detectarNodos(MAX_NODOS);
+#endif
+    for (int nodo = 0; nodo < MAX_NODOS; nodo++) {
+        arenas[nodo].actual = nullptr;
+        arenas[nodo].usados = 0;
+        for (int clase = 0; clase <= MAX_CLASE; clase++) {
+            arenas[nodo].libres[clase] = nullptr;
+        }
+    }
+}
+
+void MemoriaHistorial::habilitar(bool paginasGrandes) {
+    this->paginasGrandes = paginasGrandes;
+    habilitado.store(true, std::memory_order_release);
+}
+
+bool MemoriaHistorial::estaHabilitado() const {
+    return habilitado.load(std::memory_order_acquire);
+}
+
+int MemoriaHistorial::nodoActual() const {
+#ifdef __linux__
+    unsigned int cpu = 0;
+    unsigned int nodo = 0;
+    if (numNodos > 1 && syscall(SYS_getcpu, &cpu, &nodo, nullptr) == 0 &&
+        nodo < static_cast<unsigned int>(numNodos)) {
+        return static_cast<int>(nodo);
+    }
+#endif
+    return 0;
+}
+
+int MemoriaHistorial::obtenerNumNodos() const {
+    return numNodos;
+}
+
+void* MemoriaHistorial::reservar(std::size_t bytes, int nodo, std::size_t& bytesReales) {
+    if (nodo < 0 || nodo >= numNodos) {
+        nodo = 0;
+    }
+    if (nodoActual() == nodo) {
+        reservasLocales.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        reservasRemotas.fetch_add(1, std::memory_order_relaxed);
+    }
+
+#ifdef __linux__
+    int clase = claseDe(bytes);
+    if (clase > MAX_CLASE) {
+        // Losa mayor que la clase máxima: región propia
+        bytesReales = (bytes + TAM_REGION - 1) / TAM_REGION * TAM_REGION;
+        unsigned char* region = mapearRegion(bytesReales, nodo);
+        if (region == nullptr) {
+            throw std::bad_alloc();
+        }
+        return region;
+    }
+
+    std::size_t tamano = static_cast<std::size_t>(1) << clase;
+    bytesReales = tamano;
+    Arena& arena = arenas[nodo];
+    std::lock_guard<std::mutex> guardia(arena.candado);
+
+    if (arena.libres[clase] != nullptr) {
+        Libre* losa = arena.libres[clase];
+        arena.libres[clase] = losa->siguiente;
+        return losa;
+    }
+
+    if (arena.actual == nullptr || arena.usados + tamano > TAM_REGION) {
+        // El resto de la región anterior se reparte en losas libres de clases menores
+        while (arena.actual != nullptr && TAM_REGION - arena.usados >= (static_cast<std::size_t>(1) << MIN_CLASE)) {
+            int resto = MAX_CLASE;
+            while ((static_cast<std::size_t>(1) << resto) > TAM_REGION - arena.usados) {
+                resto--;
+            }
+            Libre* losa = reinterpret_cast<Libre*>(arena.actual + arena.usados);
+            losa->siguiente = arena.libres[resto];
+            arena.libres[resto] = losa;
+            arena.usados += static_cast<std::size_t>(1) << resto;
+        }
+
+        unsigned char* region = mapearRegion(TAM_REGION, nodo);
+        if (region == nullptr) {
+            throw std::bad_alloc();
+        }
+        arena.actual = region;
+        arena.usados = 0;
+    }
+
+    void* losa = arena.actual + arena.usados;
+    arena.usados += tamano;
+    return losa;
+#else
+    bytesReales = bytes;
+    return ::operator new(bytes);
+#endif
+}
+
+void MemoriaHistorial::liberar(void* memoria, std::size_t bytesReales, int nodo) {
+#ifdef __linux__
+    if (bytesReales > (static_cast<std::size_t>(1) << MAX_CLASE)) {
+        munmap(memoria, bytesReales);
+        return;
+    }
+    if (nodo < 0 || nodo >= numNodos) {
+        nodo = 0;
+    }
+    Arena& arena = arenas[nodo];
+    int clase = claseDe(bytesReales);
+    std::lock_guard<std::mutex> guardia(arena.candado);
+    Libre* losa = static_cast<Libre*>(memoria);
+    losa->siguiente = arena.libres[clase];
+    arena.libres[clase] = losa;
+#else
+    (void)bytesReales;
+    (void)nodo;
+    ::operator delete(memoria);
+#endif
+}
+
+EstadisticasMemoria MemoriaHistorial::obtenerEstadisticas() const {
+    EstadisticasMemoria estadisticas;
+    estadisticas.reservasLocales = reservasLocales.load(std::memory_order_relaxed);
+    estadisticas.reservasRemotas = reservasRemotas.load(std::memory_order_relaxed);
+    estadisticas.regionesGrandes = regionesGrandes.load(std::memory_order_relaxed);
+    estadisticas.regionesAconsejadas = regionesAconsejadas.load(std::memory_order_relaxed);
+    estadisticas.regionesNormales = regionesNormales.load(std::memory_order_relaxed);
+    estadisticas.enlacesFallidos = enlacesFallidos.load(std::memory_order_relaxed);
+    estadisticas.bytesRegiones = bytesRegiones.load(std::memory_order_relaxed);
+    return estadisticas;
+}
+
+void MemoriaHistorial::imprimirEstadisticas(std::ostream& salida) const {
+    EstadisticasMemoria estadisticas = obtenerEstadisticas();
+    salida << "[Log] Memoria de historiales: " << estadisticas.bytesRegiones / 1024 << " KiB en "
+           << numNodos << " nodo(s); regiones con páginas de 2 MB: " << estadisticas.regionesGrandes
+           << ", con madvise: " << estadisticas.regionesAconsejadas
+           << ", normales: " << estadisticas.regionesNormales
+           << "; losas locales/remotas: " << estadisticas.reservasLocales << "/" << estadisticas.reservasRemotas;
+    if (estadisticas.enlacesFallidos > 0) {
+        salida << " (" << estadisticas.enlacesFallidos << " sin fijar a su nodo)";
+    }
+    salida << "." << std::endl;
+}
+
+unsigned char* MemoriaHistorial::mapearRegion(std::size_t bytes, int nodo) {
+#ifdef __linux__
+    void* region = MAP_FAILED;
+    bool grandes = false;
+#ifdef MAP_HUGETLB
+    if (paginasGrandes) {
+        // Solo funciona si el administrador reservó páginas (vm.nr_hugepages)
+        region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        grandes = region != MAP_FAILED;
+    }
+#endif
+    if (region == MAP_FAILED) {
+        // Se mapea de más para recortar a una dirección alineada a 2 MB
+        std::size_t extendido = bytes + TAM_REGION;
+        void* crudo = mmap(nullptr, extendido, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (crudo == MAP_FAILED) {
+            return nullptr;
+        }
+        std::size_t inicio = reinterpret_cast<std::size_t>(crudo);
+        std::size_t alineado = (inicio + TAM_REGION - 1) / TAM_REGION * TAM_REGION;
+        if (alineado > inicio) {
+            munmap(crudo, alineado - inicio);
+        }
+        std::size_t sobrante = inicio + extendido - (alineado + bytes);
+        if (sobrante > 0) {
+            munmap(reinterpret_cast<void*>(alineado + bytes), sobrante);
+        }
+        region = reinterpret_cast<void*>(alineado);
+    }
+
+    if (grandes) {
+        regionesGrandes.fetch_add(1, std::memory_order_relaxed);
+    } else {
+#ifdef MADV_HUGEPAGE
+        if (paginasGrandes && madvise(region, bytes, MADV_HUGEPAGE) == 0) {
+            regionesAconsejadas.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            regionesNormales.fetch_add(1, std::memory_order_relaxed);
+        }
+#else
+        regionesNormales.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    // Fijar antes del primer acceso para que las páginas nazcan en su nodo
+    if (numNodos > 1) {
+        unsigned long mascara = 1ul << nodo;
+        if (syscall(SYS_mbind, region, bytes, POLITICA_ENLAZAR, &mascara,
+                    static_cast<unsigned long>(MAX_NODOS) + 1, 0) != 0) {
+            enlacesFallidos.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    bytesRegiones.fetch_add(bytes, std::memory_order_relaxed);
+    return static_cast<unsigned char*>(region);
+#else
+    (void)bytes;
+    (void)nodo;
+    return nullptr;
+#endif
+}
+
+int MemoriaHistorial::claseDe(std::size_t bytes) {
+    int clase = MIN_CLASE;
+    while (clase <= MAX_CLASE && (static_cast<std::size_t>(1) << clase) < bytes) {
+        clase++;
+    }
+    return clase;
+}
@@ -0,0 +1,261 @@
+/**
+ * @file MotorReglas.cpp
+ * @brief Implementación del motor incremental de reglas
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#include "../include/MotorReglas.h"
+#include "../include/FabricaSensores.h"
+#include <sstream>
+#include <string>
+#include <cmath>
+
+MotorReglas::MotorReglas() : numReglas(0), enlaces(nullptr), capacidadEnlaces(0) {
+}
+
+MotorReglas::~MotorReglas() {
+    for (int i = 0; i < capacidadEnlaces; i++) {
+        limpiarEnlace(enlaces[i]);
+    }
+    delete[] enlaces;
+}
+
+int MotorReglas::agregarRegla(const char* especificacion) {
+    if (numReglas == MAX_REGLAS) {
+        return -1;
+    }
+
+    std::istringstream entrada(especificacion);
+    std::string objetivo;
+    std::string operador;
+    Regla regla;
+    regla.ventana = 1;
+    regla.duracion = 0.0;
+    regla.activa = true;
+
+    if (!(entrada >> objetivo >> operador)) {
+        return -1;
+    }
+
+    // Objetivo: sensor por nombre o todos los de un tipo
+    if (objetivo.compare(0, 5, "tipo:") == 0) {
+        if (!buscarTipoPorClave(objetivo.c_str() + 5, regla.tipo)) {
+            return -1;
+        }
+        regla.porTipo = true;
+        regla.sensor[0] = '\0';
+    } else if (objetivo.size() >= TAM_NOMBRE_SENSOR) {
+        return -1;
+    } else {
+        regla.porTipo = false;
+        regla.tipo = TipoSensor::TEMPERATURA;
+        std::strcpy(regla.sensor, objetivo.c_str());
+    }
+
+    if (operador == "promedio") {
+        if (!(entrada >> regla.ventana >> operador) || regla.ventana < 1 || regla.ventana > MAX_VENTANA) {
+            return -1;
+        }
+    }
+
+    if (operador == ">") {
+        regla.comparador = ComparadorRegla::MAYOR_QUE;
+    } else if (operador == "<") {
+        regla.comparador = ComparadorRegla::MENOR_QUE;
+    } else if (operador == "variacion" && regla.ventana == 1) {
+        regla.comparador = ComparadorRegla::VARIACION;
+    } else {
+        return -1;
+    }
+
+    if (!(entrada >> regla.umbral)) {
+        return -1;
+    }
+
+    std::string palabra;
+    if (entrada >> palabra) {
+        if (palabra != "durante" || !(entrada >> regla.duracion) || regla.duracion < 0.0) {
+            return -1;
+        }
+        if (entrada >> palabra) {
+            return -1;
+        }
+    }
+
+    regla.id = numReglas;
+    reglas[numReglas++] = regla;
+    return regla.id;
+}
+
+bool MotorReglas::eliminarRegla(int id) {
+    if (id < 0 || id >= numReglas || !reglas[id].activa) {
+        return false;
+    }
+    reglas[id].activa = false;
+    return true;
+}
+
+void MotorReglas::evaluar(unsigned int manejador, TipoSensor tipo, const char* nombre,
+                          double valor, double marcaTiempo) {
+    if (numReglas == 0) {
+        return;
+    }
+
+    if (manejador >= static_cast<unsigned int>(capacidadEnlaces)) {
+        int nuevaCapacidad = capacidadEnlaces > 0 ? capacidadEnlaces : 16;
+        while (static_cast<unsigned int>(nuevaCapacidad) <= manejador) {
+            nuevaCapacidad *= 2;
+        }
+        EnlaceSensor* nuevos = new EnlaceSensor[nuevaCapacidad];
+        for (int i = 0; i < nuevaCapacidad; i++) {
+            nuevos[i] = i < capacidadEnlaces ? enlaces[i] : EnlaceSensor{nullptr, 0, 0, 0};
+        }
+        delete[] enlaces;
+        enlaces = nuevos;
+        capacidadEnlaces = nuevaCapacidad;
+    }
+
+    EnlaceSensor& enlace = enlaces[manejador];
+    if (enlace.revisadas < numReglas) {
+        actualizarEnlace(enlace, tipo, nombre);
+    }
+
+    for (int i = 0; i < enlace.cantidad; i++) {
+        EstadoRegla& estado = enlace.estados[i];
+        const Regla& regla = reglas[estado.regla];
+        if (!regla.activa) {
+            continue;
+        }
+
+        // Valor observado: lectura, variación o promedio corrido de la ventana
+        double observado = valor;
+        bool evaluable = true;
+        if (regla.comparador == ComparadorRegla::VARIACION) {
+            observado = estado.hayAnterior ? std::fabs(valor - estado.anterior) : 0.0;
+            evaluable = estado.hayAnterior;
+            estado.anterior = valor;
+            estado.hayAnterior = true;
+        } else if (estado.ventana != nullptr) {
+            if (estado.llenas == regla.ventana) {
+                estado.sumaVentana -= estado.ventana[estado.posicion];
+            } else {
+                estado.llenas++;
+            }
+            estado.ventana[estado.posicion] = valor;
+            estado.sumaVentana += valor;
+            estado.posicion = (estado.posicion + 1) % regla.ventana;
+            observado = estado.sumaVentana / estado.llenas;
+            evaluable = estado.llenas == regla.ventana;
+        }
+
+        bool cumple = evaluable &&
+                      (regla.comparador == ComparadorRegla::MENOR_QUE ? observado < regla.umbral
+                                                                      : observado > regla.umbral);
+        if (!cumple) {
+            estado.inicioCondicion = -1.0;
+            estado.disparada = false;
+            continue;
+        }
+
+        if (estado.inicioCondicion < 0.0) {
+            estado.inicioCondicion = marcaTiempo;
+        }
+        if (!estado.disparada && marcaTiempo - estado.inicioCondicion >= regla.duracion) {
+            estado.disparada = true;
+            Alerta alerta;
+            alerta.regla = regla.id;
+            alerta.manejador = manejador;
+            std::strncpy(alerta.sensor, nombre, TAM_NOMBRE_SENSOR - 1);
+            alerta.sensor[TAM_NOMBRE_SENSOR - 1] = '\0';
+            alerta.valor = observado;
+            alerta.marcaTiempo = marcaTiempo;
+            alertas.publicar(alerta);
+        }
+    }
+}
+
+void MotorReglas::olvidarSensor(unsigned int manejador) {
+    if (manejador < static_cast<unsigned int>(capacidadEnlaces)) {
+        limpiarEnlace(enlaces[manejador]);
+    }
+}
+
+const Regla* MotorReglas::obtenerRegla(int id) const {
+    if (id < 0 || id >= numReglas) {
+        return nullptr;
+    }
+    return &reglas[id];
+}
+
+int MotorReglas::obtenerCantidad() const {
+    return numReglas;
+}
+
+ColaAlertas& MotorReglas::obtenerAlertas() {
+    return alertas;
+}
+
+void MotorReglas::describir(const Regla& regla, std::ostream& salida) {
+    if (regla.porTipo) {
+        salida << "tipo:" << rasgosTipoSensor(regla.tipo).clave;
+    } else {
+        salida << regla.sensor;
+    }
+    if (regla.ventana > 1) {
+        salida << " promedio " << regla.ventana;
+    }
+    switch (regla.comparador) {
+        case ComparadorRegla::MAYOR_QUE: salida << " > "; break;
+        case ComparadorRegla::MENOR_QUE: salida << " < "; break;
+        case ComparadorRegla::VARIACION: salida << " variacion "; break;
+    }
+    salida << regla.umbral;
+    if (regla.duracion > 0.0) {
+        salida << " durante " << regla.duracion;
+    }
+}
+
+void MotorReglas::actualizarEnlace(EnlaceSensor& enlace, TipoSensor tipo, const char* nombre) {
+    for (int r = enlace.revisadas; r < numReglas; r++) {
+        const Regla& regla = reglas[r];
+        bool aplica = regla.porTipo ? regla.tipo == tipo : std::strcmp(regla.sensor, nombre) == 0;
+        if (!aplica) {
+            continue;
+        }
+
+        if (enlace.cantidad == enlace.capacidad) {
+            int nuevaCapacidad = enlace.capacidad > 0 ? enlace.capacidad * 2 : 4;
+            EstadoRegla* nuevos = new EstadoRegla[nuevaCapacidad];
+            for (int i = 0; i < enlace.cantidad; i++) {
+                nuevos[i] = enlace.estados[i];
+            }
+            delete[] enlace.estados;
+            enlace.estados = nuevos;
+            enlace.capacidad = nuevaCapacidad;
+        }
+
+        EstadoRegla& estado = enlace.estados[enlace.cantidad++];
+        estado.regla = r;
+        estado.anterior = 0.0;
+        estado.hayAnterior = false;
+        estado.ventana = regla.ventana > 1 ? new double[regla.ventana] : nullptr;
+        estado.posicion = 0;
+        estado.llenas = 0;
+        estado.sumaVentana = 0.0;
+        estado.inicioCondicion = -1.0;
+        estado.disparada = false;
+    }
+    enlace.revisadas = numReglas;
+}
+
+void MotorReglas::limpiarEnlace(EnlaceSensor& enlace) {
+    for (int i = 0; i < enlace.cantidad; i++) {
+        delete[] enlace.estados[i].ventana;
+    }
+    delete[] enlace.estados;
+    enlace.estados = nullptr;
+    enlace.cantidad = 0;
+    enlace.capacidad = 0;
+    enlace.revisadas = 0;
+}
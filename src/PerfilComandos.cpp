@@ -0,0 +1,88 @@
+/**
+ * @file PerfilComandos.cpp
+ * @brief Implementación del perfil de rendimiento por tipo de comando
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#include "../include/PerfilComandos.h"
+#include "../include/Reloj.h"
+#include <iomanip>
+
+namespace {
+
+/**
+ * @brief Microsegundos por segundo, para expresar latencias
+ */
+const double MICROSEGUNDOS = 1e6;
+
+} // namespace
+
+PerfilComandos::PerfilComandos() : inicio(0.0), fin(0.0) {
+}
+
+void PerfilComandos::iniciar() {
+    inicio = segundosMonotonicos();
+    fin = inicio;
+}
+
+void PerfilComandos::terminar() {
+    fin = segundosMonotonicos();
+}
+
+void PerfilComandos::registrar(int opcion, double segundos) {
+    if (opcion <= 0 || opcion >= MAX_OPCIONES) {
+        opcion = 0;
+    }
+    latencias[opcion].agregar(segundos);
+}
+
+void PerfilComandos::imprimirReporte(std::ostream& salida, const char* const* nombres, int numNombres) const {
+    long long total = 0;
+    for (int i = 0; i < MAX_OPCIONES; i++) {
+        total += latencias[i].obtenerCantidad();
+    }
+    double duracion = fin - inicio;
+
+    std::ios_base::fmtflags formato = salida.flags();
+    std::streamsize precision = salida.precision();
+    salida << std::fixed << std::setprecision(1);
+
+    salida << "\n=== Reporte de Rendimiento del Script ===" << std::endl;
+    salida << "Comandos ejecutados: " << total << " en " << std::setprecision(3) << duracion << " s";
+    if (duracion > 0.0) {
+        salida << " (" << std::setprecision(1) << total / duracion << " comandos/s)";
+    }
+    salida << std::endl;
+    salida << std::setprecision(1);
+    salida << std::setw(7) << "Opción" << std::setw(10) << "Ejec." << std::setw(12) << "ops/s"
+           << std::setw(11) << "media(us)" << std::setw(10) << "p50(us)" << std::setw(10) << "p95(us)"
+           << std::setw(10) << "p99(us)" << std::setw(11) << "max(us)" << "  Comando" << std::endl;
+
+    for (int i = 0; i < MAX_OPCIONES; i++) {
+        const EstadisticaFlujo& estadisticas = latencias[i];
+        long long ejecuciones = estadisticas.obtenerCantidad();
+        if (ejecuciones == 0) {
+            continue;
+        }
+        // Rendimiento del tipo de comando: ejecuciones por segundo dentro del propio comando
+        double ocupado = estadisticas.obtenerMedia() * ejecuciones;
+        const char* nombre = i == 0 ? "Opción inválida" : "";
+        if (i > 0 && i < numNombres && nombres[i] != nullptr) {
+            nombre = nombres[i];
+        }
+
+        salida << std::setw(6) << i << std::setw(10) << ejecuciones << std::setw(12)
+               << (ocupado > 0.0 ? ejecuciones / ocupado : 0.0)
+               << std::setw(11) << estadisticas.obtenerMedia() * MICROSEGUNDOS
+               << std::setw(10) << estadisticas.cuantil(0.50) * MICROSEGUNDOS
+               << std::setw(10) << estadisticas.cuantil(0.95) * MICROSEGUNDOS
+               << std::setw(10) << estadisticas.cuantil(0.99) * MICROSEGUNDOS
+               << std::setw(11) << estadisticas.obtenerMaximo() * MICROSEGUNDOS
+               << "  " << nombre << std::endl;
+    }
+    salida << "==========================================" << std::endl;
+
+    salida.flags(formato);
+    salida.precision(precision);
+}
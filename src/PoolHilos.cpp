@@ -0,0 +1,98 @@
+/**
+ * @file PoolHilos.cpp
+ * @brief Implementación del grupo fijo de hilos
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#include "../include/PoolHilos.h"
+
+PoolHilos::PoolHilos(int numHilos)
+    : hilos(nullptr), numHilos(numHilos), tarea(nullptr), contexto(nullptr), numTareas(0),
+      siguienteTarea(0), trabajando(0), ronda(0), detener(false) {
+    if (this->numHilos <= 0) {
+        int nucleos = static_cast<int>(std::thread::hardware_concurrency());
+        this->numHilos = nucleos > 1 ? nucleos - 1 : 0;
+    }
+    if (this->numHilos > 0) {
+        hilos = new std::thread[this->numHilos];
+        for (int i = 0; i < this->numHilos; i++) {
+            hilos[i] = std::thread(&PoolHilos::trabajar, this);
+        }
+    }
+}
+
+PoolHilos::~PoolHilos() {
+    {
+        std::lock_guard<std::mutex> guardia(candado);
+        detener = true;
+    }
+    hayTrabajo.notify_all();
+    for (int i = 0; i < numHilos; i++) {
+        hilos[i].join();
+    }
+    delete[] hilos;
+}
+
+void PoolHilos::ejecutar(int numTareas, TareaPool tarea, void* contexto) {
+    if (numTareas <= 0) {
+        return;
+    }
+    if (numHilos == 0 || numTareas == 1) {
+        for (int i = 0; i < numTareas; i++) {
+            tarea(i, contexto);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guardia(candado);
+        this->tarea = tarea;
+        this->contexto = contexto;
+        this->numTareas = numTareas;
+        siguienteTarea.store(0);
+        trabajando = numHilos;
+        ronda++;
+    }
+    hayTrabajo.notify_all();
+
+    procesarTareas();
+
+    std::unique_lock<std::mutex> guardia(candado);
+    terminaron.wait(guardia, [this] { return trabajando == 0; });
+}
+
+int PoolHilos::obtenerNumHilos() const {
+    return numHilos + 1;
+}
+
+void PoolHilos::trabajar() {
+    unsigned long vista = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> guardia(candado);
+            hayTrabajo.wait(guardia, [this, vista] { return detener || ronda != vista; });
+            if (detener) {
+                return;
+            }
+            vista = ronda;
+        }
+
+        procesarTareas();
+
+        std::lock_guard<std::mutex> guardia(candado);
+        if (--trabajando == 0) {
+            terminaron.notify_one();
+        }
+    }
+}
+
+void PoolHilos::procesarTareas() {
+    for (;;) {
+        int indice = siguienteTarea.fetch_add(1);
+        if (indice >= numTareas) {
+            return;
+        }
+        tarea(indice, contexto);
+    }
+}
@@ -0,0 +1,230 @@
+/**
+ * @file PublicadorMemoria.cpp
+ * @brief Implementación del escritor del segmento compartido de sensores
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#include "../include/PublicadorMemoria.h"
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MEMORIA_COMPARTIDA_POSIX 1
+#endif
+
+#ifdef MEMORIA_COMPARTIDA_POSIX
+namespace {
+
+/**
+ * @brief Proceso que publica en un segmento existente, si sigue vivo
+ *
+ * Un segmento sin firma válida o cuyo escritor ya terminó (p. ej. tras una
+ * ejecución abortada) se considera abandonado.
+ *
+ * @param nombre Nombre POSIX del segmento
+ * @return PID del escritor en ejecución, o 0 si el segmento está abandonado
+ */
+std::int64_t escritorVivo(const char* nombre) {
+    int descriptor = shm_open(nombre, O_RDONLY, 0);
+    if (descriptor < 0) {
+        return 0;
+    }
+    struct stat info;
+    std::int64_t pid = 0;
+    if (fstat(descriptor, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(EncabezadoSegmento)) {
+        void* memoria = mmap(nullptr, sizeof(EncabezadoSegmento), PROT_READ, MAP_SHARED, descriptor, 0);
+        if (memoria != MAP_FAILED) {
+            EncabezadoSegmento encabezado;
+            std::memcpy(&encabezado, memoria, sizeof(encabezado));
+            munmap(memoria, sizeof(EncabezadoSegmento));
+            if (encabezado.magia == EncabezadoSegmento::MAGIA && encabezado.pidEscritor > 0 &&
+                encabezado.pidEscritor != static_cast<std::int64_t>(getpid()) &&
+                (kill(static_cast<pid_t>(encabezado.pidEscritor), 0) == 0 || errno == EPERM)) {
+                pid = encabezado.pidEscritor;
+            }
+        }
+    }
+    close(descriptor);
+    return pid;
+}
+
+} // namespace
+#endif
+
+PublicadorMemoria::PublicadorMemoria()
+    : mapeo(nullptr), tamano(0), ranuras(nullptr), numRanuras(0), advertidoFuera(false) {
+    nombreSegmento[0] = '\0';
+}
+
+PublicadorMemoria::~PublicadorMemoria() {
+    cerrar();
+}
+
+bool PublicadorMemoria::abrir(const char* nombre, int numRanuras) {
+    cerrar();
+    if (nombre == nullptr || nombre[0] != '/' || std::strlen(nombre) >= sizeof(nombreSegmento) || numRanuras <= 0) {
+        return false;
+    }
+
+#ifdef MEMORIA_COMPARTIDA_POSIX
+    std::size_t bytes = tamanoSegmento(static_cast<std::uint32_t>(numRanuras));
+
+    int descriptor = shm_open(nombre, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (descriptor < 0 && errno == EEXIST) {
+        // Solo se reemplaza un segmento abandonado; el de otro escritor vivo se respeta
+        std::int64_t pid = escritorVivo(nombre);
+        if (pid != 0) {
+            std::cout << "Error: el segmento " << nombre << " ya lo publica el proceso " << pid
+                      << "; use otro nombre con --shm." << std::endl;
+            return false;
+        }
+        shm_unlink(nombre);
+        descriptor = shm_open(nombre, O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (descriptor < 0) {
+        return false;
+    }
+    if (ftruncate(descriptor, static_cast<off_t>(bytes)) != 0) {
+        close(descriptor);
+        shm_unlink(nombre);
+        return false;
+    }
+    void* memoria = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (memoria == MAP_FAILED) {
+        shm_unlink(nombre);
+        return false;
+    }
+
+    std::strcpy(nombreSegmento, nombre);
+    mapeo = memoria;
+    tamano = bytes;
+    this->numRanuras = static_cast<std::uint32_t>(numRanuras);
+    advertidoFuera.store(false, std::memory_order_relaxed);
+    ranuras = reinterpret_cast<RanuraSensor*>(static_cast<unsigned char*>(memoria) + desplazamientoRanuras());
+
+    for (int i = 0; i < numRanuras; i++) {
+        RanuraSensor* ranura = new (&ranuras[i]) RanuraSensor;
+        ranura->secuencia.store(0, std::memory_order_relaxed);
+        ranura->escritas.store(0, std::memory_order_relaxed);
+        std::memset(&ranura->estadisticas, 0, sizeof(ranura->estadisticas));
+    }
+
+    // La firma se escribe al final: un lector que la ve encuentra las ranuras listas
+    EncabezadoSegmento* encabezado = static_cast<EncabezadoSegmento*>(memoria);
+    encabezado->version = EncabezadoSegmento::VERSION;
+    encabezado->numRanuras = this->numRanuras;
+    encabezado->lecturasRecientes = RanuraSensor::LECTURAS_RECIENTES;
+    encabezado->pidEscritor = static_cast<std::int64_t>(getpid());
+    std::atomic_thread_fence(std::memory_order_release);
+    encabezado->magia = EncabezadoSegmento::MAGIA;
+
+    std::cout << "[Log] Segmento " << nombreSegmento << " publicado: " << numRanuras
+              << " ranuras, " << bytes << " bytes." << std::endl;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PublicadorMemoria::cerrar() {
+#ifdef MEMORIA_COMPARTIDA_POSIX
+    if (mapeo != nullptr) {
+        munmap(mapeo, tamano);
+        shm_unlink(nombreSegmento);
+    }
+#endif
+    mapeo = nullptr;
+    tamano = 0;
+    ranuras = nullptr;
+    numRanuras = 0;
+    nombreSegmento[0] = '\0';
+}
+
+bool PublicadorMemoria::estaAbierto() const {
+    return mapeo != nullptr;
+}
+
+void PublicadorMemoria::publicarAlta(unsigned int manejador, const SensorBase& sensor, double marcaTiempo) {
+    if (!tieneRanura(manejador, sensor)) {
+        return;
+    }
+    RanuraSensor& ranura = ranuras[manejador];
+
+    // Un manejador reutilizado ignora las lecturas del sensor anterior
+    EstadisticaPublicada alta = resumir(sensor, marcaTiempo);
+    alta.inicioAnillo = ranura.escritas.load(std::memory_order_relaxed);
+    escribirEstadisticas(ranura, alta);
+}
+
+void PublicadorMemoria::publicarLecturas(unsigned int manejador, const SensorBase& sensor,
+                                         const double* valores, int cantidad, double marcaTiempo) {
+    if (!tieneRanura(manejador, sensor)) {
+        return;
+    }
+    RanuraSensor& ranura = ranuras[manejador];
+
+    std::uint64_t escritas = ranura.escritas.load(std::memory_order_relaxed);
+    for (int i = 0; i < cantidad; i++) {
+        ranura.anillo[escritas % RanuraSensor::LECTURAS_RECIENTES].store(valores[i], std::memory_order_release);
+        ranura.escritas.store(++escritas, std::memory_order_release);
+    }
+
+    EstadisticaPublicada resumen = resumir(sensor, marcaTiempo);
+    resumen.inicioAnillo = ranura.estadisticas.inicioAnillo;  // Solo este proceso la escribe
+    escribirEstadisticas(ranura, resumen);
+}
+
+void PublicadorMemoria::publicarBaja(unsigned int manejador) {
+    if (manejador >= numRanuras) {
+        return;
+    }
+    EstadisticaPublicada vacia;
+    std::memset(&vacia, 0, sizeof(vacia));
+    escribirEstadisticas(ranuras[manejador], vacia);
+}
+
+bool PublicadorMemoria::tieneRanura(unsigned int manejador, const SensorBase& sensor) {
+    if (manejador < numRanuras) {
+        return true;
+    }
+    if (!advertidoFuera.exchange(true, std::memory_order_relaxed)) {
+        std::cout << "Advertencia: el sensor '" << sensor.obtenerNombre() << "' (manejador " << manejador
+                  << ") no cabe en el segmento " << nombreSegmento << " de " << numRanuras
+                  << " ranuras; no se publicarán los sensores fuera de él (use --shm "
+                  << nombreSegmento << ":RANURAS)." << std::endl;
+    }
+    return false;
+}
+
+void PublicadorMemoria::escribirEstadisticas(RanuraSensor& ranura, const EstadisticaPublicada& estadisticas) {
+    std::uint32_t secuencia = ranura.secuencia.load(std::memory_order_relaxed);
+    ranura.secuencia.store(secuencia + 1, std::memory_order_relaxed);  // Impar: escritura en curso
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&ranura.estadisticas, &estadisticas, sizeof(estadisticas));
+    ranura.secuencia.store(secuencia + 2, std::memory_order_release);
+}
+
+EstadisticaPublicada PublicadorMemoria::resumir(const SensorBase& sensor, double marcaTiempo) {
+    const EstadisticaFlujo& flujo = sensor.obtenerEstadisticas();
+    EstadisticaPublicada resumen;
+    std::memset(&resumen, 0, sizeof(resumen));
+    resumen.activa = 1;
+    resumen.tipo = sensor.obtenerTipo();
+    std::strncpy(resumen.nombre, sensor.obtenerNombre(), TAM_NOMBRE_SENSOR - 1);
+    resumen.numLecturas = flujo.obtenerCantidad();
+    if (resumen.numLecturas > 0) {
+        resumen.media = flujo.obtenerMedia();
+        resumen.desviacion = flujo.obtenerDesviacion();
+        resumen.minimo = flujo.obtenerMinimo();
+        resumen.maximo = flujo.obtenerMaximo();
+    }
+    resumen.ultimaLectura = marcaTiempo;
+    return resumen;
+}
@@ -0,0 +1,484 @@
+/**
+ * @file RegistroColumnar.cpp
+ * @brief Implementación del registro columnar de sensores
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ */
+
+#include "../include/RegistroColumnar.h"
+#include "../include/PoolHilos.h"
+
+namespace {
+
+/**
+ * @brief Redimensiona una columna conservando sus primeras filas
+ * @tparam C Tipo de elemento de la columna
+ * @param columna Columna a redimensionar (se reemplaza)
+ * @param usadas Filas a conservar
+ * @param nuevaCapacidad Nueva capacidad de la columna
+ */
+template <typename C>
+void redimensionar(C*& columna, int usadas, int nuevaCapacidad) {
+    C* nueva = new C[nuevaCapacidad];
+    if (columna != nullptr) {
+        std::memcpy(nueva, columna, sizeof(C) * usadas);
+        delete[] columna;
+    }
+    columna = nueva;
+}
+
+/**
+ * @brief Filas que reduce cada tarea de una consulta de flota
+ *
+ * Es fijo para que el orden de las sumas no dependa del número de hilos.
+ */
+const int TAM_TRAMO_FLOTA = 4096;
+
+/**
+ * @brief Agregado parcial de un tramo de filas
+ */
+struct ParcialFlota {
+    int sensores;
+    int conLecturas;
+    long long lecturas;
+    double suma;
+    double sumaPromedios;
+    double minimo;
+    double maximo;
+};
+
+/**
+ * @brief Datos compartidos por las tareas de una consulta de flota
+ */
+struct TrabajoFlota {
+    const ConsultaFlota* consulta;
+    const TipoSensor* tipos;
+    const long long* numLecturas;
+    const double* sumas;
+    const double* minimos;
+    const double* maximos;
+    int cantidad;
+    ParcialFlota* parciales;  ///< Un parcial por tramo
+};
+
+/**
+ * @brief Reduce un tramo de filas a su parcial
+ * @param tramo Índice del tramo
+ * @param contexto Puntero al TrabajoFlota
+ */
+void reducirTramo(int tramo, void* contexto) {
+    const TrabajoFlota& trabajo = *static_cast<TrabajoFlota*>(contexto);
+    const ConsultaFlota& consulta = *trabajo.consulta;
+    int inicio = tramo * TAM_TRAMO_FLOTA;
+    int fin = inicio + TAM_TRAMO_FLOTA < trabajo.cantidad ? inicio + TAM_TRAMO_FLOTA : trabajo.cantidad;
+
+    ParcialFlota parcial = {0, 0, 0, 0.0, 0.0, 0.0, 0.0};
+    for (int i = inicio; i < fin; i++) {
+        if (consulta.porTipo && trabajo.tipos[i] != consulta.tipo) {
+            continue;
+        }
+        long long lecturas = trabajo.numLecturas[i];
+        if (lecturas == 0) {
+            if (consulta.filtro == FiltroPromedio::NINGUNO) {
+                parcial.sensores++;
+            }
+            continue;
+        }
+        double promedio = trabajo.sumas[i] / static_cast<double>(lecturas);
+        if ((consulta.filtro == FiltroPromedio::MAYOR_QUE && !(promedio > consulta.umbral)) ||
+            (consulta.filtro == FiltroPromedio::MENOR_QUE && !(promedio < consulta.umbral))) {
+            continue;
+        }
+
+        if (parcial.conLecturas == 0 || trabajo.minimos[i] < parcial.minimo) {
+            parcial.minimo = trabajo.minimos[i];
+        }
+        if (parcial.conLecturas == 0 || trabajo.maximos[i] > parcial.maximo) {
+            parcial.maximo = trabajo.maximos[i];
+        }
+        parcial.sensores++;
+        parcial.conLecturas++;
+        parcial.lecturas += lecturas;
+        parcial.suma += trabajo.sumas[i];
+        parcial.sumaPromedios += promedio;
+    }
+    trabajo.parciales[tramo] = parcial;
+}
+
+} // namespace
+
+RegistroColumnar::RegistroColumnar(int capacidadInicial)
+    : tipos(nullptr), manejadores(nullptr), nombres(nullptr), numLecturas(nullptr),
+      sumas(nullptr), minimos(nullptr), maximos(nullptr), ultimasLecturas(nullptr),
+      cantidad(0), capacidad(0),
+      sensores(nullptr), filaPorManejador(nullptr), capacidadManejadores(0), primerLibre(-1),
+      generaciones(nullptr), procesadas(nullptr), pendientes(nullptr), numPendientes(0), capacidadPendientes(0),
+      indice(nullptr), capacidadIndice(0), ocupadasIndice(0), tumbasIndice(0) {
+    reservar(capacidadInicial > 0 ? capacidadInicial : 1);
+}
+
+RegistroColumnar::~RegistroColumnar() {
+    delete[] tipos;
+    delete[] manejadores;
+    delete[] nombres;
+    delete[] numLecturas;
+    delete[] sumas;
+    delete[] minimos;
+    delete[] maximos;
+    delete[] ultimasLecturas;
+    delete[] sensores;
+    delete[] filaPorManejador;
+    delete[] generaciones;
+    delete[] procesadas;
+    delete[] pendientes;
+    delete[] indice;
+}
+
+unsigned int RegistroColumnar::agregar(SensorBase* sensor, double marcaTiempo) {
+    if (buscar(sensor->obtenerNombre()) != SIN_MANEJADOR) {
+        return SIN_MANEJADOR;
+    }
+
+    if (cantidad == capacidad) {
+        reservar(capacidad * 2);
+    }
+
+    unsigned int manejador = tomarManejador();
+    int fila = cantidad++;
+
+    tipos[fila] = sensor->obtenerTipo();
+    manejadores[fila] = manejador;
+    std::strncpy(nombres[fila], sensor->obtenerNombre(), TAM_NOMBRE_SENSOR - 1);
+    nombres[fila][TAM_NOMBRE_SENSOR - 1] = '\0';
+    numLecturas[fila] = 0;
+    sumas[fila] = 0.0;
+    minimos[fila] = 0.0;
+    maximos[fila] = 0.0;
+    ultimasLecturas[fila] = marcaTiempo;
+
+    sensores[manejador] = sensor;
+    filaPorManejador[manejador] = fila;
+    generaciones[manejador] = 0;
+    procesadas[manejador] = 0;
+    indexar(manejador);
+    if ((ocupadasIndice + tumbasIndice) * 4 >= capacidadIndice * 3) {
+        reconstruirIndice(capacidadIndice);
+    }
+    return manejador;
+}
+
+SensorBase* RegistroColumnar::eliminar(unsigned int manejador) {
+    int fila = obtenerFila(manejador);
+    if (fila < 0) {
+        return nullptr;
+    }
+    SensorBase* sensor = sensores[manejador];
+
+    // Retirar el nombre del índice dejando una tumba para no cortar las cadenas de sondeo
+    unsigned int mascara = static_cast<unsigned int>(capacidadIndice - 1);
+    unsigned int ranura = hashNombre(nombres[fila]) & mascara;
+    while (indice[ranura] != manejador) {
+        ranura = (ranura + 1) & mascara;
+    }
+    indice[ranura] = TUMBA;
+    ocupadasIndice--;
+    tumbasIndice++;
+
+    // Mover la última fila al hueco
+    int ultima = --cantidad;
+    if (fila != ultima) {
+        tipos[fila] = tipos[ultima];
+        manejadores[fila] = manejadores[ultima];
+        std::memcpy(nombres[fila], nombres[ultima], TAM_NOMBRE_SENSOR);
+        numLecturas[fila] = numLecturas[ultima];
+        sumas[fila] = sumas[ultima];
+        minimos[fila] = minimos[ultima];
+        maximos[fila] = maximos[ultima];
+        ultimasLecturas[fila] = ultimasLecturas[ultima];
+        filaPorManejador[manejadores[fila]] = fila;
+    }
+
+    // Devolver el manejador a la lista de libres
+    sensores[manejador] = nullptr;
+    filaPorManejador[manejador] = primerLibre;
+    primerLibre = static_cast<int>(manejador);
+
+    if (capacidad > 64 && cantidad < capacidad / 4) {
+        ajustarCapacidad(capacidad / 2);
+    } else if ((ocupadasIndice + tumbasIndice) * 4 >= capacidadIndice * 3) {
+        reconstruirIndice(capacidadIndice);
+    }
+    return sensor;
+}
+
+unsigned int RegistroColumnar::buscar(const char* nombre) const {
+    unsigned int mascara = static_cast<unsigned int>(capacidadIndice - 1);
+    unsigned int ranura = hashNombre(nombre) & mascara;
+
+    while (indice[ranura] != SIN_MANEJADOR) {
+        unsigned int manejador = indice[ranura];
+        if (manejador != TUMBA && std::strcmp(nombres[filaPorManejador[manejador]], nombre) == 0) {
+            return manejador;
+        }
+        ranura = (ranura + 1) & mascara;
+    }
+    return SIN_MANEJADOR;
+}
+
+SensorBase* RegistroColumnar::obtenerSensor(unsigned int manejador) const {
+    return obtenerFila(manejador) >= 0 ? sensores[manejador] : nullptr;
+}
+
+int RegistroColumnar::obtenerFila(unsigned int manejador) const {
+    if (manejador >= static_cast<unsigned int>(capacidadManejadores) || sensores[manejador] == nullptr) {
+        return -1;
+    }
+    return filaPorManejador[manejador];
+}
+
+void RegistroColumnar::acumularLectura(unsigned int manejador, double valor, double marcaTiempo) {
+    int fila = filaPorManejador[manejador];
+
+    if (numLecturas[fila] == 0) {
+        minimos[fila] = valor;
+        maximos[fila] = valor;
+    } else {
+        if (valor < minimos[fila]) {
+            minimos[fila] = valor;
+        }
+        if (valor > maximos[fila]) {
+            maximos[fila] = valor;
+        }
+    }
+    sumas[fila] += valor;
+    numLecturas[fila]++;
+    ultimasLecturas[fila] = marcaTiempo;
+    marcarModificado(manejador);
+}
+
+void RegistroColumnar::sincronizarFila(unsigned int manejador, const EstadisticaFlujo& estadisticas,
+                                       double marcaTiempo) {
+    int fila = filaPorManejador[manejador];
+    long long cantidad = estadisticas.obtenerCantidad();
+
+    numLecturas[fila] = cantidad;
+    sumas[fila] = estadisticas.obtenerMedia() * static_cast<double>(cantidad);
+    minimos[fila] = cantidad > 0 ? estadisticas.obtenerMinimo() : 0.0;
+    maximos[fila] = cantidad > 0 ? estadisticas.obtenerMaximo() : 0.0;
+    ultimasLecturas[fila] = marcaTiempo;
+    marcarModificado(manejador);
+}
+
+bool RegistroColumnar::estaModificado(unsigned int manejador) const {
+    return obtenerFila(manejador) >= 0 && generaciones[manejador] != procesadas[manejador];
+}
+
+unsigned long long RegistroColumnar::obtenerGeneracion(unsigned int manejador) const {
+    return obtenerFila(manejador) >= 0 ? generaciones[manejador] : 0;
+}
+
+void RegistroColumnar::marcarProcesado(unsigned int manejador) {
+    if (obtenerFila(manejador) >= 0) {
+        procesadas[manejador] = generaciones[manejador];
+    }
+}
+
+const unsigned int* RegistroColumnar::listaPendientes() const {
+    return pendientes;
+}
+
+int RegistroColumnar::obtenerNumPendientes() const {
+    return numPendientes;
+}
+
+void RegistroColumnar::vaciarPendientes() {
+    numPendientes = 0;
+}
+
+ResumenSensor RegistroColumnar::obtenerResumen(int fila) const {
+    ResumenSensor resumen;
+    resumen.manejador = manejadores[fila];
+    resumen.tipo = tipos[fila];
+    resumen.nombre = nombres[fila];
+    resumen.numLecturas = numLecturas[fila];
+    resumen.suma = sumas[fila];
+    resumen.minimo = minimos[fila];
+    resumen.maximo = maximos[fila];
+    resumen.ultimaLectura = ultimasLecturas[fila];
+    return resumen;
+}
+
+void RegistroColumnar::reservar(int nuevaCapacidad) {
+    if (nuevaCapacidad > capacidad) {
+        ajustarCapacidad(nuevaCapacidad);
+    }
+    if (nuevaCapacidad > capacidadManejadores) {
+        crecerManejadores(nuevaCapacidad);
+    }
+}
+
+double RegistroColumnar::promedioDePromedios() const {
+    double suma = 0.0;
+    int conLecturas = 0;
+
+    for (int i = 0; i < cantidad; i++) {
+        if (numLecturas[i] > 0) {
+            suma += sumas[i] / static_cast<double>(numLecturas[i]);
+            conLecturas++;
+        }
+    }
+
+    return conLecturas > 0 ? suma / conLecturas : 0.0;
+}
+
+AgregadoFlota RegistroColumnar::consultar(const ConsultaFlota& consulta, PoolHilos* hilos) const {
+    int numTramos = (cantidad + TAM_TRAMO_FLOTA - 1) / TAM_TRAMO_FLOTA;
+    ParcialFlota* parciales = new ParcialFlota[numTramos > 0 ? numTramos : 1];
+    TrabajoFlota trabajo = {&consulta, tipos, numLecturas, sumas, minimos, maximos, cantidad, parciales};
+
+    if (hilos != nullptr && numTramos > 1) {
+        hilos->ejecutar(numTramos, reducirTramo, &trabajo);
+    } else {
+        for (int tramo = 0; tramo < numTramos; tramo++) {
+            reducirTramo(tramo, &trabajo);
+        }
+    }
+
+    // Combinación en orden de tramo: el resultado no depende de qué hilo redujo cada uno
+    ParcialFlota total = {0, 0, 0, 0.0, 0.0, 0.0, 0.0};
+    for (int tramo = 0; tramo < numTramos; tramo++) {
+        const ParcialFlota& parcial = parciales[tramo];
+        if (parcial.conLecturas > 0) {
+            if (total.conLecturas == 0 || parcial.minimo < total.minimo) {
+                total.minimo = parcial.minimo;
+            }
+            if (total.conLecturas == 0 || parcial.maximo > total.maximo) {
+                total.maximo = parcial.maximo;
+            }
+        }
+        total.sensores += parcial.sensores;
+        total.conLecturas += parcial.conLecturas;
+        total.lecturas += parcial.lecturas;
+        total.suma += parcial.suma;
+        total.sumaPromedios += parcial.sumaPromedios;
+    }
+    delete[] parciales;
+
+    AgregadoFlota agregado;
+    agregado.sensores = total.sensores;
+    agregado.conLecturas = total.conLecturas;
+    agregado.lecturas = total.lecturas;
+    agregado.media = total.lecturas > 0 ? total.suma / static_cast<double>(total.lecturas) : 0.0;
+    agregado.promedioDePromedios = total.conLecturas > 0 ? total.sumaPromedios / total.conLecturas : 0.0;
+    agregado.minimo = total.minimo;
+    agregado.maximo = total.maximo;
+    return agregado;
+}
+
+int RegistroColumnar::obtenerCantidad() const {
+    return cantidad;
+}
+
+int RegistroColumnar::obtenerCapacidadManejadores() const {
+    return capacidadManejadores;
+}
+
+bool RegistroColumnar::estaVacio() const {
+    return cantidad == 0;
+}
+
+void RegistroColumnar::ajustarCapacidad(int nuevaCapacidad) {
+    redimensionar(tipos, cantidad, nuevaCapacidad);
+    redimensionar(manejadores, cantidad, nuevaCapacidad);
+    redimensionar(nombres, cantidad, nuevaCapacidad);
+    redimensionar(numLecturas, cantidad, nuevaCapacidad);
+    redimensionar(sumas, cantidad, nuevaCapacidad);
+    redimensionar(minimos, cantidad, nuevaCapacidad);
+    redimensionar(maximos, cantidad, nuevaCapacidad);
+    redimensionar(ultimasLecturas, cantidad, nuevaCapacidad);
+    capacidad = nuevaCapacidad;
+
+    // El índice se mantiene con factor de carga <= 1/2 respecto a la capacidad
+    int ranuras = 16;
+    while (ranuras < capacidad * 2) {
+        ranuras *= 2;
+    }
+    reconstruirIndice(ranuras);
+}
+
+unsigned int RegistroColumnar::tomarManejador() {
+    if (primerLibre < 0) {
+        crecerManejadores(capacidadManejadores > 0 ? capacidadManejadores * 2 : 16);
+    }
+
+    unsigned int manejador = static_cast<unsigned int>(primerLibre);
+    primerLibre = filaPorManejador[primerLibre];
+    return manejador;
+}
+
+void RegistroColumnar::crecerManejadores(int nuevaCapacidad) {
+    int anterior = capacidadManejadores;
+
+    redimensionar(sensores, anterior, nuevaCapacidad);
+    redimensionar(filaPorManejador, anterior, nuevaCapacidad);
+    redimensionar(generaciones, anterior, nuevaCapacidad);
+    redimensionar(procesadas, anterior, nuevaCapacidad);
+
+    // Encadenar las nuevas entradas delante de la lista de libres
+    for (int i = anterior; i < nuevaCapacidad; i++) {
+        sensores[i] = nullptr;
+        filaPorManejador[i] = (i + 1 < nuevaCapacidad) ? i + 1 : primerLibre;
+    }
+    primerLibre = anterior;
+    capacidadManejadores = nuevaCapacidad;
+}
+
+void RegistroColumnar::indexar(unsigned int manejador) {
+    unsigned int mascara = static_cast<unsigned int>(capacidadIndice - 1);
+    unsigned int ranura = hashNombre(nombres[filaPorManejador[manejador]]) & mascara;
+
+    while (indice[ranura] != SIN_MANEJADOR && indice[ranura] != TUMBA) {
+        ranura = (ranura + 1) & mascara;
+    }
+    if (indice[ranura] == TUMBA) {
+        tumbasIndice--;
+    }
+    indice[ranura] = manejador;
+    ocupadasIndice++;
+}
+
+void RegistroColumnar::marcarModificado(unsigned int manejador) {
+    // Solo la transición de procesado a modificado agrega una entrada
+    if (generaciones[manejador]++ == procesadas[manejador]) {
+        if (numPendientes == capacidadPendientes) {
+            int nueva = capacidadPendientes > 0 ? capacidadPendientes * 2 : 16;
+            redimensionar(pendientes, numPendientes, nueva);
+            capacidadPendientes = nueva;
+        }
+        pendientes[numPendientes++] = manejador;
+    }
+}
+
+void RegistroColumnar::reconstruirIndice(int nuevaCapacidad) {
+    delete[] indice;
+    indice = new unsigned int[nuevaCapacidad];
+    for (int i = 0; i < nuevaCapacidad; i++) {
+        indice[i] = SIN_MANEJADOR;
+    }
+    capacidadIndice = nuevaCapacidad;
+    ocupadasIndice = 0;
+    tumbasIndice = 0;
+
+    for (int fila = 0; fila < cantidad; fila++) {
+        indexar(manejadores[fila]);
+    }
+}
+
+unsigned int RegistroColumnar::hashNombre(const char* nombre) {
+    unsigned int hash = 2166136261u;
+    while (*nombre != '\0') {
+        hash ^= static_cast<unsigned char>(*nombre++);
+        hash *= 16777619u;
+    }
+    return hash;
+}
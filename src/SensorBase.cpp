@@ -7,12 +7,12 @@
 
 #include "../include/SensorBase.h"
 
-SensorBase::SensorBase() {
+SensorBase::SensorBase() : ultimoProcesamiento() {
     std::strcpy(nombre, "Sensor_Default");
     std::cout << "[Log] SensorBase creado: " << nombre << std::endl;
 }
 
-SensorBase::SensorBase(const char* nombreSensor) {
+SensorBase::SensorBase(const char* nombreSensor) : ultimoProcesamiento() {
     std::strncpy(nombre, nombreSensor, sizeof(nombre) - 1);
     nombre[sizeof(nombre) - 1] = '\0';  // Asegurar terminación nula
     std::cout << "[Log] SensorBase creado: " << nombre << std::endl;
@@ -29,4 +29,8 @@ const char* SensorBase::obtenerNombre() const {
 void SensorBase::establecerNombre(const char* nombreSensor) {
     std::strncpy(nombre, nombreSensor, sizeof(nombre) - 1);
     nombre[sizeof(nombre) - 1] = '\0';  // Asegurar terminación nula
-}
\ No newline at end of file
+}
+
+const ResultadoProcesamiento& SensorBase::obtenerUltimoProcesamiento() const {
+    return ultimoProcesamiento;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file consulta.cpp
+ * @brief Proceso de consulta sobre el segmento compartido del sistema de sensores
+ * @author Santiago Euresti
+ * @date 30 de octubre de 2024
+ *
+ * Programa de vida corta que mapea en solo lectura el segmento publicado por
+ * `sensor_iot_system --shm` y muestra los equivalentes de imprimirInfo y
+ * mostrarHistorial sin detener la ingesta.
+ */
+
+#include "../include/LectorMemoria.h"
+#include <iostream>
+
+/**
+ * @brief Muestra la forma de uso del programa
+ */
+void mostrarUso() {
+    std::cout << "Uso: sensor_iot_consulta [--shm NOMBRE] (listar | info SENSOR | historial SENSOR)" << std::endl;
+}
+
+/**
+ * @brief Imprime las estadísticas publicadas de un sensor
+ * @param estadisticas Instantánea de la ranura
+ */
+void imprimirInfo(const EstadisticaPublicada& estadisticas) {
+    std::cout << "=== Información del Sensor de " << nombreTipoSensor(estadisticas.tipo) << " ===" << std::endl;
+    std::cout << "Nombre: " << estadisticas.nombre << std::endl;
+    std::cout << "Tipo: " << nombreTipoSensor(estadisticas.tipo) << std::endl;
+    std::cout << "Lecturas registradas: " << estadisticas.numLecturas << std::endl;
+    if (estadisticas.numLecturas > 0) {
+        std::cout << "Promedio de ingesta: " << estadisticas.media << std::endl;
+        std::cout << "Desviación estándar: " << estadisticas.desviacion << std::endl;
+        std::cout << "Mínimo/Máximo: " << estadisticas.minimo << " / " << estadisticas.maximo << std::endl;
+    }
+    std::cout << "=============================================" << std::endl;
+}
+
+/**
+ * @brief Función principal del proceso de consulta
+ * @param argc Número de argumentos
+ * @param argv Argumentos de línea de comandos
+ * @return 0 si la consulta se resolvió, 1 en caso contrario
+ */
+int main(int argc, char* argv[]) {
+    const char* segmento = NOMBRE_SEGMENTO_SENSORES;
+    int i = 1;
+    if (i + 1 < argc && std::strcmp(argv[i], "--shm") == 0) {
+        segmento = argv[i + 1];
+        i += 2;
+    }
+    if (i >= argc) {
+        mostrarUso();
+        return 1;
+    }
+    const char* comando = argv[i];
+    const char* sensor = i + 1 < argc ? argv[i + 1] : nullptr;
+
+    LectorMemoria lector;
+    if (!lector.abrir(segmento)) {
+        std::cout << "Error: No se pudo abrir el segmento '" << segmento << "'." << std::endl;
+        return 1;
+    }
+
+    if (std::strcmp(comando, "listar") == 0) {
+        std::cout << "--- Sensores publicados por el proceso " << lector.obtenerPidEscritor() << " ---" << std::endl;
+        EstadisticaPublicada estadisticas;
+        int publicados = 0;
+        for (int ranura = 0; ranura < lector.obtenerNumRanuras(); ranura++) {
+            if (lector.leerEstadisticas(ranura, estadisticas)) {
+                std::cout << ++publicados << ". " << estadisticas.nombre << " (ID " << ranura << "): "
+                          << estadisticas.numLecturas << " lecturas" << std::endl;
+            }
+        }
+        if (publicados == 0) {
+            std::cout << "No hay sensores registrados." << std::endl;
+        }
+        return 0;
+    }
+
+    if (sensor == nullptr || (std::strcmp(comando, "info") != 0 && std::strcmp(comando, "historial") != 0)) {
+        mostrarUso();
+        return 1;
+    }
+
+    int ranura = lector.buscar(sensor);
+    EstadisticaPublicada estadisticas;
+    if (ranura < 0 || !lector.leerEstadisticas(ranura, estadisticas)) {
+        std::cout << "Error: Sensor '" << sensor << "' no encontrado." << std::endl;
+        return 1;
+    }
+
+    if (std::strcmp(comando, "info") == 0) {
+        imprimirInfo(estadisticas);
+    } else {
+        std::cout << "Historial reciente de " << estadisticas.nombre << ": Lista: ";
+        int visitadas = lector.recorrerRecientes(ranura, [](double valor) { std::cout << valor << " "; });
+        std::cout << std::endl << "(" << visitadas << " de " << estadisticas.numLecturas << " lecturas)" << std::endl;
+    }
+    return 0;
+}
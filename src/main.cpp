@@ -5,321 +5,935 @@
  * @date 30 de octubre de 2024
  * 
  * Este programa implementa un sistema de gestión polimórfica que maneja
- * diferentes tipos de sensores usando listas enlazadas simples genéricas.
+ * diferentes tipos de sensores usando listas enlazadas simples genéricas
+ * y un registro columnar para sus metadatos.
  */
 
 #include "../include/SensorBase.h"
-#include "../include/SensorTemperatura.h"
-#include "../include/SensorPresion.h"
+#include "../include/FabricaSensores.h"
 #include "../include/ListaSensor.h"
+#include "../include/ListaGestion.h"
+#include "../include/PerfilComandos.h"
+#include "../include/Reloj.h"
+#include "../include/MemoriaHistorial.h"
+#include "../include/BucleEventos.h"
 #include <iostream>
+#include <fstream>
+#include <iomanip>
 #include <limits>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 /**
- * @brief Estructura de nodo para la lista de gestión polimórfica (no genérica)
+ * @brief Texto de cada opción del menú (OPCIONES_MENU[i] para la opción i)
  */
-struct NodoSensor {
-    SensorBase* sensor;         ///< Puntero a la clase base para polimorfismo
-    NodoSensor* siguiente;      ///< Puntero al siguiente nodo
-    
-    /**
-     * @brief Constructor del nodo
-     * @param s Puntero al sensor
-     */
-    NodoSensor(SensorBase* s) : sensor(s), siguiente(nullptr) {}
+const char* const OPCIONES_MENU[] = {
+    nullptr,
+    "Crear Sensor de Temperatura (FLOAT)",
+    "Crear Sensor de Presión (INT)",
+    "Registrar Lectura en Sensor",
+    "Ejecutar Procesamiento Polimórfico",
+    "Mostrar Información de Sensor",
+    "Listar Todos los Sensores",
+    "Mostrar Historial de Sensor",
+    "Cerrar Sistema (Liberar Memoria)",
+    "Eliminar Sensor",
+    "Registrar Lote de Lecturas",
+    "Agregar Regla de Alerta",
+    "Listar Reglas de Alerta",
+    "Exportar Historiales a Archivo",
+    "Consultar Flota",
+    "Procesamiento Incremental"
 };
 
 /**
- * @brief Clase para gestionar la lista polimórfica de sensores
+ * @brief Número de entradas de OPCIONES_MENU
  */
-class ListaGestion {
-private:
-    NodoSensor* cabeza;         ///< Primer nodo de la lista
+const int NUM_OPCIONES_MENU = sizeof(OPCIONES_MENU) / sizeof(OPCIONES_MENU[0]);
 
-public:
-    /**
-     * @brief Constructor
-     */
-    ListaGestion() : cabeza(nullptr) {
-        std::cout << "[Log] Lista de Gestión Polimórfica creada." << std::endl;
+/**
+ * @brief Descriptor de la entrada estándar (consola)
+ */
+const int FD_CONSOLA = 0;
+
+/**
+ * @brief Fuentes de ingesta (`--fuente`) admitidas a la vez
+ */
+const int MAX_FUENTES = 16;
+
+/**
+ * @brief Muestra el menú principal del sistema
+ */
+void mostrarMenu() {
+    std::cout << "\n=== Sistema IoT de Monitoreo Polimórfico ===" << std::endl;
+    for (int i = 1; i < NUM_OPCIONES_MENU; i++) {
+        std::cout << i << ". " << OPCIONES_MENU[i] << std::endl;
+    }
+    std::cout << "Seleccione una opción: ";
+}
+
+/**
+ * @brief Función para limpiar el buffer de entrada
+ * @param entrada Flujo a restablecer (descarta el resto de la línea)
+ */
+void limpiarBuffer(std::istream& entrada) {
+    entrada.clear();
+    entrada.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+}
+
+/**
+ * @brief Lee el nombre de un sensor como dato de una opción
+ * @param entrada Flujo del que se lee
+ * @param mensaje Indicación que se muestra antes de leer
+ * @param nombre Recibe el nombre (se trunca a TAM_NOMBRE_SENSOR - 1 caracteres)
+ * @return false si no había nombre; el error ya se informó y se descartó la línea
+ */
+bool leerNombreSensor(std::istream& entrada, const char* mensaje, char (&nombre)[TAM_NOMBRE_SENSOR]) {
+    std::cout << mensaje;
+    entrada >> std::setw(sizeof(nombre)) >> nombre;
+    if (entrada.fail()) {
+        std::cout << "Error: Se esperaba el nombre del sensor." << std::endl;
+        limpiarBuffer(entrada);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Lee un nombre y da de alta un sensor del tipo indicado
+ * @param listaGestion Lista de gestión que recibe el sensor
+ * @param entrada Flujo del que se lee el nombre
+ * @param tipo Tipo del sensor a crear
+ */
+void crearSensorDeTipo(ListaGestion& listaGestion, std::istream& entrada, TipoSensor tipo) {
+    std::cout << "Ingrese el nombre del sensor de " << rasgosTipoSensor(tipo).lectura << ": ";
+    char nombre[TAM_NOMBRE_SENSOR];
+    if (!leerNombreSensor(entrada, "", nombre)) {
+        return;
     }
     
-    /**
-     * @brief Destructor - libera toda la memoria
-     */
-    ~ListaGestion() {
-        std::cout << "\n--- Liberación de Memoria en Cascada ---" << std::endl;
-        while (cabeza != nullptr) {
-            NodoSensor* temp = cabeza;
-            cabeza = cabeza->siguiente;
+    SensorBase* sensor = crearSensor(tipo, nombre);
+    if (!listaGestion.insertarSensor(sensor)) {
+        delete sensor;
+    }
+}
+
+/**
+ * @brief Ejecuta una opción del menú leyendo sus datos de un flujo de entrada
+ * 
+ * Es el mismo código para la consola y para el modo script; solo cambia el
+ * flujo del que se leen los datos de cada opción.
+ * 
+ * @param opcion Opción del menú
+ * @param listaGestion Lista de gestión sobre la que se opera
+ * @param entrada Flujo del que se leen los datos de la opción
+ */
+void ejecutarComando(int opcion, ListaGestion& listaGestion, std::istream& entrada) {
+    switch (opcion) {
+        case 1: {
+            std::cout << "\nOpción 1: Crear Sensor (Tipo Temp - FLOAT)" << std::endl;
+            crearSensorDeTipo(listaGestion, entrada, TipoSensor::TEMPERATURA);
+            break;
+        }
+        
+        case 2: {
+            std::cout << "\nOpción 2: Crear Sensor (Tipo Presión - INT)" << std::endl;
+            crearSensorDeTipo(listaGestion, entrada, TipoSensor::PRESION);
+            break;
+        }
+        
+        case 3: {
+            std::cout << "\nOpción 3: Registrar Lectura" << std::endl;
+            char nombre[TAM_NOMBRE_SENSOR];
+            if (!leerNombreSensor(entrada, "Ingrese el nombre del sensor: ", nombre)) {
+                break;
+            }
+            
+            SensorBase* sensor = listaGestion.buscarSensor(nombre);
+            if (sensor == nullptr) {
+                std::cout << "Error: Sensor '" << nombre << "' no encontrado." << std::endl;
+                break;
+            }
+            
+            TipoSensor tipo = sensor->obtenerTipo();
+            double valor;
+            std::cout << "Ingrese la lectura de " << rasgosTipoSensor(tipo).lectura
+                      << " (" << nombreTipoLectura(tipo) << "): ";
+            entrada >> valor;
+            
+            if (entrada.fail()) {
+                std::cout << "Error: Valor inválido para " << rasgosTipoSensor(tipo).lectura << "." << std::endl;
+                limpiarBuffer(entrada);
+                break;
+            }
+            double lectura;
+            if (!convertirLectura(tipo, valor, lectura)) {
+                std::cout << "Error: Valor inválido para " << rasgosTipoSensor(tipo).lectura << "." << std::endl;
+                break;
+            }
             
-            std::cout << "[Destructor General] Liberando Nodo: " 
-                      << temp->sensor->obtenerNombre() << "." << std::endl;
-            delete temp->sensor;  // Llama al destructor virtual apropiado
-            delete temp;
+            listaGestion.registrarLectura(nombre, lectura);
+            std::cout << "ID: " << nombre << ". Valor: " << lectura << " (" << nombreTipoLectura(tipo) << ")" << std::endl;
+            break;
         }
-        std::cout << "Sistema cerrado. Memoria limpia." << std::endl;
-    }
-    
-    /**
-     * @brief Inserta un sensor en la lista de gestión
-     * @param sensor Puntero al sensor a insertar
-     */
-    void insertarSensor(SensorBase* sensor) {
-        NodoSensor* nuevoNodo = new NodoSensor(sensor);
         
-        if (cabeza == nullptr) {
-            cabeza = nuevoNodo;
-        } else {
-            NodoSensor* actual = cabeza;
-            while (actual->siguiente != nullptr) {
-                actual = actual->siguiente;
+        case 4: {
+            std::cout << "\nOpción 4: Ejecutar Procesamiento Polimórfico" << std::endl;
+            listaGestion.ejecutarProcesamientoPolimorfico();
+            break;
+        }
+        
+        case 5: {
+            std::cout << "\nOpción 5: Mostrar Información de Sensor" << std::endl;
+            char nombre[TAM_NOMBRE_SENSOR];
+            if (!leerNombreSensor(entrada, "Ingrese el nombre del sensor: ", nombre)) {
+                break;
+            }
+            
+            SensorBase* sensor = listaGestion.buscarSensor(nombre);
+            if (sensor != nullptr) {
+                sensor->imprimirInfo();
+            } else {
+                std::cout << "Error: Sensor '" << nombre << "' no encontrado." << std::endl;
+            }
+            break;
+        }
+        
+        case 6: {
+            std::cout << "\nOpción 6: Listar Todos los Sensores" << std::endl;
+            listaGestion.mostrarTodosSensores();
+            break;
+        }
+        
+        case 7: {
+            std::cout << "\nOpción 7: Mostrar Historial de Sensor" << std::endl;
+            char nombre[TAM_NOMBRE_SENSOR];
+            if (!leerNombreSensor(entrada, "Ingrese el nombre del sensor: ", nombre)) {
+                break;
+            }
+            
+            SensorBase* sensor = listaGestion.buscarSensor(nombre);
+            if (sensor == nullptr) {
+                std::cout << "Error: Sensor '" << nombre << "' no encontrado." << std::endl;
+                break;
             }
-            actual->siguiente = nuevoNodo;
+            
+            sensor->mostrarHistorial();
+            break;
+        }
+        
+        case 8: {
+            std::cout << "\nOpción 8: Cerrar Sistema (Liberar Memoria)" << std::endl;
+            std::cout << "Cerrando sistema..." << std::endl;
+            break;
+        }
+        
+        case 9: {
+            std::cout << "\nOpción 9: Eliminar Sensor" << std::endl;
+            char nombre[TAM_NOMBRE_SENSOR];
+            if (!leerNombreSensor(entrada, "Ingrese el nombre del sensor: ", nombre)) {
+                break;
+            }
+            
+            if (listaGestion.eliminarSensor(nombre)) {
+                std::cout << "Sensor '" << nombre << "' eliminado." << std::endl;
+            } else {
+                std::cout << "Error: Sensor '" << nombre << "' no encontrado." << std::endl;
+            }
+            break;
         }
         
-        std::cout << "Sensor '" << sensor->obtenerNombre() 
-                  << "' creado e insertado en la lista de gestión." << std::endl;
+        case 10: {
+            std::cout << "\nOpción 10: Registrar Lote de Lecturas" << std::endl;
+            char nombre[TAM_NOMBRE_SENSOR];
+            if (!leerNombreSensor(entrada, "Ingrese el nombre del sensor: ", nombre)) {
+                break;
+            }
+            
+            if (listaGestion.buscarSensor(nombre) == nullptr) {
+                std::cout << "Error: Sensor '" << nombre << "' no encontrado." << std::endl;
+                break;
+            }
+            
+            int cantidad;
+            std::cout << "Ingrese la cantidad de lecturas: ";
+            entrada >> cantidad;
+            if (entrada.fail() || cantidad <= 0) {
+                std::cout << "Error: Cantidad inválida." << std::endl;
+                limpiarBuffer(entrada);
+                break;
+            }
+            
+            double* valores = new double[cantidad];
+            std::cout << "Ingrese las " << cantidad << " lecturas separadas por espacios: ";
+            int leidas = 0;
+            while (leidas < cantidad && entrada >> valores[leidas]) {
+                leidas++;
+            }
+            
+            if (leidas < cantidad) {
+                std::cout << "Error: Se esperaban " << cantidad << " lecturas y se leyeron "
+                          << leidas << "." << std::endl;
+                limpiarBuffer(entrada);
+            } else {
+                int registradas = listaGestion.registrarLecturas(nombre, valores, cantidad);
+                std::cout << "ID: " << nombre << ". Lote de " << registradas << " lecturas registrado." << std::endl;
+                if (registradas < cantidad) {
+                    std::cout << "Advertencia: " << cantidad - registradas
+                              << " lecturas descartadas (no finitas o fuera de rango)." << std::endl;
+                }
+            }
+            delete[] valores;
+            break;
+        }
+        
+        case 11: {
+            std::cout << "\nOpción 11: Agregar Regla de Alerta" << std::endl;
+            std::cout << "Formato: <sensor|";
+            escribirClavesTipos(std::cout, "tipo:");
+            std::cout << "> [promedio N] (>|<|variacion) <umbral> [durante S]" << std::endl;
+            std::cout << "Ingrese la regla: ";
+            char especificacion[128];
+            entrada >> std::ws;
+            entrada.getline(especificacion, sizeof(especificacion));
+            
+            if (entrada.fail()) {
+                std::cout << "Error: Regla demasiado larga." << std::endl;
+                limpiarBuffer(entrada);
+                break;
+            }
+            
+            int id = listaGestion.agregarRegla(especificacion);
+            if (id < 0) {
+                std::cout << "Error: Regla inválida." << std::endl;
+            } else {
+                std::cout << "Regla #" << id << " agregada." << std::endl;
+            }
+            break;
+        }
+        
+        case 12: {
+            std::cout << "\nOpción 12: Listar Reglas de Alerta" << std::endl;
+            listaGestion.mostrarReglas();
+            break;
+        }
+        
+        case 13: {
+            std::cout << "\nOpción 13: Exportar Historiales a Archivo" << std::endl;
+            char nombre[TAM_NOMBRE_SENSOR];
+            if (!leerNombreSensor(entrada, "Ingrese el nombre del sensor (* para todos): ", nombre)) {
+                break;
+            }
+            
+            char formato[8];
+            std::cout << "Ingrese el formato (csv|bin): ";
+            entrada >> std::setw(sizeof(formato)) >> formato;
+            if (entrada.fail() || (std::strcmp(formato, "csv") != 0 && std::strcmp(formato, "bin") != 0)) {
+                std::cout << "Error: Formato inválido." << std::endl;
+                limpiarBuffer(entrada);
+                break;
+            }
+            
+            char ruta[256];
+            std::cout << "Ingrese la ruta del archivo: ";
+            entrada >> std::setw(sizeof(ruta)) >> ruta;
+            if (entrada.fail()) {
+                std::cout << "Error: Se esperaba la ruta del archivo." << std::endl;
+                limpiarBuffer(entrada);
+                break;
+            }
+            
+            bool todos = std::strcmp(nombre, "*") == 0;
+            int exportados = listaGestion.exportarHistoriales(
+                ruta, formato[0] == 'b' ? FormatoExportacion::BINARIO : FormatoExportacion::CSV,
+                todos ? nullptr : nombre);
+            if (exportados >= 0) {
+                std::cout << exportados << " historial(es) exportado(s) a '" << ruta << "'." << std::endl;
+            } else if (!todos && listaGestion.buscarSensor(nombre) == nullptr) {
+                std::cout << "Error: Sensor '" << nombre << "' no encontrado." << std::endl;
+            } else {
+                std::cout << "Error: No se pudo escribir '" << ruta << "'." << std::endl;
+            }
+            break;
+        }
+        
+        case 14: {
+            std::cout << "\nOpción 14: Consultar Flota" << std::endl;
+            char tipo[16] = "";
+            std::cout << "Ingrese el tipo (todos|";
+            escribirClavesTipos(std::cout, "");
+            std::cout << "): ";
+            entrada >> std::setw(sizeof(tipo)) >> tipo;
+            if (entrada.fail()) {
+                std::cout << "Error: Tipo inválido." << std::endl;
+                limpiarBuffer(entrada);
+                break;
+            }
+            
+            ConsultaFlota consulta = {true, TipoSensor::TEMPERATURA, FiltroPromedio::NINGUNO, 0.0};
+            if (std::strcmp(tipo, "todos") == 0) {
+                consulta.porTipo = false;
+            } else if (!buscarTipoPorClave(tipo, consulta.tipo)) {
+                std::cout << "Error: Tipo inválido." << std::endl;
+                break;
+            }
+            
+            char filtro[4] = "";
+            std::cout << "Filtrar por promedio (- ninguno | > umbral | < umbral): ";
+            entrada >> std::setw(sizeof(filtro)) >> filtro;
+            if (entrada.fail()) {
+                std::cout << "Error: Filtro inválido." << std::endl;
+                limpiarBuffer(entrada);
+                break;
+            }
+            if (std::strcmp(filtro, ">") == 0 || std::strcmp(filtro, "<") == 0) {
+                consulta.filtro = filtro[0] == '>' ? FiltroPromedio::MAYOR_QUE : FiltroPromedio::MENOR_QUE;
+                std::cout << "Ingrese el umbral: ";
+                entrada >> consulta.umbral;
+                if (entrada.fail()) {
+                    std::cout << "Error: Umbral inválido." << std::endl;
+                    limpiarBuffer(entrada);
+                    break;
+                }
+            } else if (std::strcmp(filtro, "-") != 0) {
+                std::cout << "Error: Filtro inválido." << std::endl;
+                break;
+            }
+            
+            double inicio = segundosMonotonicos();
+            AgregadoFlota agregado = listaGestion.consultarFlota(consulta);
+            double milisegundos = (segundosMonotonicos() - inicio) * 1000.0;
+            
+            std::cout << "Sensores: " << agregado.sensores << " (" << agregado.conLecturas
+                      << " con lecturas, " << agregado.lecturas << " lecturas)" << std::endl;
+            if (agregado.conLecturas > 0) {
+                std::cout << "Media: " << agregado.media << ", promedio de promedios: "
+                          << agregado.promedioDePromedios << std::endl;
+                std::cout << "Mínimo: " << agregado.minimo << ", máximo: " << agregado.maximo << std::endl;
+            }
+            std::cout << "[Log] Consulta de flota resuelta en " << milisegundos << " ms." << std::endl;
+            break;
+        }
+        
+        case 15: {
+            std::cout << "\nOpción 15: Procesamiento Incremental" << std::endl;
+            listaGestion.ejecutarProcesamientoIncremental();
+            break;
+        }
+        
+        default: {
+            std::cout << "Error: Opción inválida. Seleccione una opción del 1 al 15." << std::endl;
+            break;
+        }
     }
-    
+}
+
+/**
+ * @brief Búfer de flujo de solo lectura sobre una línea ya leída
+ */
+class LineaScript : public std::streambuf {
+public:
     /**
-     * @brief Busca un sensor por nombre
-     * @param nombre Nombre del sensor a buscar
-     * @return Puntero al sensor encontrado o nullptr si no existe
+     * @brief Expone un arreglo de caracteres como contenido del flujo
+     * @param inicio Primer carácter de la línea
+     * @param largo Caracteres de la línea (sin el salto de línea)
      */
-    SensorBase* buscarSensor(const char* nombre) {
-        NodoSensor* actual = cabeza;
-        while (actual != nullptr) {
-            if (std::strcmp(actual->sensor->obtenerNombre(), nombre) == 0) {
-                return actual->sensor;
-            }
-            actual = actual->siguiente;
+    void asignar(char* inicio, std::size_t largo) {
+        setg(inicio, inicio, inicio + largo);
+    }
+};
+
+/**
+ * @brief Lee una línea completa del script, sin importar su longitud
+ * @param script Flujo del script
+ * @param linea Búfer de la línea (crece según se necesite)
+ * @param capacidad Capacidad del búfer
+ * @param largo Caracteres leídos (sin el salto de línea)
+ * @return false si ya no quedan líneas
+ */
+bool leerLineaScript(std::istream& script, char*& linea, std::size_t& capacidad, std::size_t& largo) {
+    largo = 0;
+    int caracter = script.get();
+    if (caracter == std::char_traits<char>::eof()) {
+        return false;
+    }
+    while (caracter != std::char_traits<char>::eof() && caracter != '\n') {
+        if (largo + 1 >= capacidad) {
+            std::size_t nuevaCapacidad = capacidad * 2;
+            char* nueva = new char[nuevaCapacidad];
+            std::memcpy(nueva, linea, largo);
+            delete[] linea;
+            linea = nueva;
+            capacidad = nuevaCapacidad;
         }
-        return nullptr;
+        linea[largo++] = static_cast<char>(caracter);
+        caracter = script.get();
+    }
+    if (largo > 0 && linea[largo - 1] == '\r') {
+        largo--;
+    }
+    linea[largo] = '\0';
+    return true;
+}
+
+/**
+ * @brief Ejecuta una línea de comando: la opción seguida de sus datos
+ * 
+ * Lo que sobre de la línea se descarta, de modo que un comando erróneo no
+ * arrastra al siguiente. Las líneas vacías o que empiezan con `#` se ignoran.
+ * 
+ * @param linea Línea a ejecutar (sin el salto de línea)
+ * @param largo Caracteres de la línea
+ * @param numLinea Número de línea para los mensajes de error
+ * @param listaGestion Lista de gestión sobre la que se opera
+ * @param perfil Perfil donde se registra la latencia (nullptr: no se mide)
+ * @return Opción ejecutada, 0 si la línea no empieza con un número, -1 si se ignoró
+ */
+int ejecutarLinea(char* linea, std::size_t largo, int numLinea, ListaGestion& listaGestion, PerfilComandos* perfil) {
+    LineaScript bufer;
+    bufer.asignar(linea, largo);
+    std::istream comando(&bufer);
+    comando >> std::ws;
+    if (comando.peek() == std::char_traits<char>::eof() || comando.peek() == '#') {
+        return -1;
     }
     
-    /**
-     * @brief Ejecuta el procesamiento polimórfico en todos los sensores
-     */
-    void ejecutarProcesamientoPolimorfico() {
-        if (cabeza == nullptr) {
-            std::cout << "No hay sensores registrados para procesar." << std::endl;
-            return;
+    int opcion;
+    comando >> opcion;
+    if (comando.fail()) {
+        std::cout << "Error: Línea " << numLinea << ": se esperaba un número de opción." << std::endl;
+        if (perfil != nullptr) {
+            perfil->registrar(0, 0.0);
         }
-        
-        std::cout << "\n--- Ejecutando Polimorfismo ---" << std::endl;
-        NodoSensor* actual = cabeza;
-        while (actual != nullptr) {
-            actual->sensor->procesarLectura();  // Llamada polimórfica
-            actual = actual->siguiente;
+        return 0;
+    }
+    
+    double inicio = segundosMonotonicos();
+    ejecutarComando(opcion, listaGestion, comando);
+    if (perfil != nullptr) {
+        perfil->registrar(opcion, segundosMonotonicos() - inicio);
+    }
+    
+    listaGestion.atenderAlertas();
+    return opcion;
+}
+
+/**
+ * @brief Ejecuta un script de comandos y mide cada uno
+ * 
+ * Cada línea es un comando (ver ejecutarLinea()).
+ * 
+ * @param script Flujo del script
+ * @param listaGestion Lista de gestión sobre la que se opera
+ * @param perfil Perfil donde se registra la latencia de cada comando
+ */
+void ejecutarScript(std::istream& script, ListaGestion& listaGestion, PerfilComandos& perfil) {
+    std::size_t capacidad = 256;
+    std::size_t largo = 0;
+    char* linea = new char[capacidad];
+    int numLinea = 0;
+    
+    while (leerLineaScript(script, linea, capacidad, largo)) {
+        numLinea++;
+        if (ejecutarLinea(linea, largo, numLinea, listaGestion, &perfil) == 8) {
+            break;
         }
     }
+    delete[] linea;
+}
+
+/**
+ * @brief Atiende la consola dentro del bucle de eventos
+ * 
+ * Cada línea tecleada es un comando completo, con la misma sintaxis que los
+ * scripts (por ejemplo `3 T-001 45.3`), así que nunca se queda esperando un
+ * dato a mitad de comando. La opción 8 detiene el bucle; el fin de la entrada
+ * (stdin redirigido o cerrado) solo termina esta tarea, y las fuentes y el
+ * procesamiento periódico siguen atendiéndose.
+ * 
+ * @param bucle Bucle de eventos
+ * @param listaGestion Lista de gestión sobre la que se opera
+ */
+TareaEventos atenderConsola(BucleEventos& bucle, ListaGestion& listaGestion) {
+    LectorLineas lector(FD_CONSOLA);
+    int numLinea = 0;
+    bool abierta = true;
     
-    /**
-     * @brief Muestra información de todos los sensores
-     */
-    void mostrarTodosSensores() {
-        if (cabeza == nullptr) {
-            std::cout << "No hay sensores registrados." << std::endl;
-            return;
+    mostrarMenu();
+    std::cout << std::endl << "(Un comando completo por línea, por ejemplo: 3 T-001 45.3)" << std::endl;
+    std::cout << "> " << std::flush;
+    for (;;) {
+        std::size_t largo;
+        char* linea;
+        while ((linea = lector.siguienteLinea(largo)) != nullptr) {
+            numLinea++;
+            if (ejecutarLinea(linea, largo, numLinea, listaGestion, nullptr) == 8) {
+                bucle.detener();
+                co_return;
+            }
+            std::cout << "> " << std::flush;
         }
-        
-        std::cout << "\n--- Lista de Sensores Registrados ---" << std::endl;
-        NodoSensor* actual = cabeza;
-        int contador = 1;
-        while (actual != nullptr) {
-            std::cout << contador << ". " << actual->sensor->obtenerNombre() << std::endl;
-            actual = actual->siguiente;
-            contador++;
+        if (!abierta) {
+            break;
         }
+        co_await bucle.esperarLectura(FD_CONSOLA);
+        abierta = lector.llenar();
     }
     
-    /**
-     * @brief Verifica si la lista está vacía
-     * @return true si está vacía, false en caso contrario
-     */
-    bool estaVacia() const {
-        return cabeza == nullptr;
+    std::cout << "[Log] Consola cerrada; la ingesta continúa hasta que se cierren las fuentes "
+              << "o llegue SIGINT/SIGTERM." << std::endl;
+}
+
+/**
+ * @brief Ingiere las lecturas de un descriptor dentro del bucle de eventos
+ * 
+ * Cada línea tiene el formato `TIPO:NOMBRE:VALOR` (ver ListaGestion::ingerirLinea()).
+ * 
+ * @param bucle Bucle de eventos
+ * @param listaGestion Lista de gestión que recibe las lecturas
+ * @param fd Descriptor de la fuente
+ * @param ruta Nombre de la fuente para los mensajes
+ */
+TareaEventos atenderFuente(BucleEventos& bucle, ListaGestion& listaGestion, int fd, const char* ruta) {
+    LectorLineas lector(fd);
+    long long lecturas = 0;
+    long long rechazadas = 0;
+    bool abierta = true;
+    
+    for (;;) {
+        std::size_t largo;
+        char* linea;
+        while ((linea = lector.siguienteLinea(largo)) != nullptr) {
+            if (largo == 0) {
+                continue;
+            }
+            if (listaGestion.ingerirLinea(linea)) {
+                lecturas++;
+            } else {
+                std::cout << "Advertencia: Fuente '" << ruta << "': línea inválida '" << linea << "'." << std::endl;
+                rechazadas++;
+            }
+        }
+        listaGestion.atenderAlertas();
+        if (!abierta) {
+            break;
+        }
+        co_await bucle.esperarLectura(fd);
+        abierta = lector.llenar();
     }
-};
+    
+    std::cout << "[Log] Fuente '" << ruta << "' cerrada: " << lecturas << " lecturas";
+    if (rechazadas > 0) {
+        std::cout << " (" << rechazadas << " líneas inválidas)";
+    }
+    std::cout << "." << std::endl;
+}
 
 /**
- * @brief Muestra el menú principal del sistema
+ * @brief Ejecuta el procesamiento de los sensores modificados cada cierto tiempo
+ * 
+ * Se usa la pasada incremental: la completa descartaría en cada período el
+ * mínimo de los sensores de temperatura aunque no hubieran recibido lecturas.
+ * 
+ * @param bucle Bucle de eventos
+ * @param listaGestion Lista de gestión a procesar
+ * @param segundos Período en segundos
  */
-void mostrarMenu() {
-    std::cout << "\n=== Sistema IoT de Monitoreo Polimórfico ===" << std::endl;
-    std::cout << "1. Crear Sensor de Temperatura (FLOAT)" << std::endl;
-    std::cout << "2. Crear Sensor de Presión (INT)" << std::endl;
-    std::cout << "3. Registrar Lectura en Sensor" << std::endl;
-    std::cout << "4. Ejecutar Procesamiento Polimórfico" << std::endl;
-    std::cout << "5. Mostrar Información de Sensor" << std::endl;
-    std::cout << "6. Listar Todos los Sensores" << std::endl;
-    std::cout << "7. Mostrar Historial de Sensor" << std::endl;
-    std::cout << "8. Cerrar Sistema (Liberar Memoria)" << std::endl;
-    std::cout << "Seleccione una opción: ";
+TareaEventos procesarPeriodicamente(BucleEventos& bucle, ListaGestion& listaGestion, double segundos) {
+    for (;;) {
+        co_await bucle.dormir(segundos);
+        if (listaGestion.tieneLecturasNuevas()) {
+            listaGestion.ejecutarProcesamientoIncremental();
+            listaGestion.atenderAlertas();
+        }
+    }
 }
 
 /**
- * @brief Función para limpiar el buffer de entrada
+ * @brief Abre una fuente de ingesta sin bloqueo
+ * 
+ * Las FIFO se abren en lectura y escritura para que la fuente siga abierta
+ * aunque el dispositivo que escribe se desconecte y vuelva a conectarse.
+ * 
+ * @param ruta Ruta de la FIFO, dispositivo o archivo
+ * @return Descriptor abierto, o -1 si no se pudo abrir
+ */
+int abrirFuente(const char* ruta) {
+#ifdef __linux__
+    struct stat info;
+    int modo = stat(ruta, &info) == 0 && S_ISFIFO(info.st_mode) ? O_RDWR : O_RDONLY;
+    return open(ruta, modo | O_NONBLOCK | O_CLOEXEC);
+#else
+    (void)ruta;
+    return -1;
+#endif
+}
+
+/**
+ * @brief Cierra un descriptor abierto con abrirFuente()
+ * @param fd Descriptor
  */
-void limpiarBuffer() {
-    std::cin.clear();
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+void cerrarFuente(int fd) {
+#ifdef __linux__
+    close(fd);
+#else
+    (void)fd;
+#endif
+}
+
+/**
+ * @brief Atiende consola, fuentes y procesamiento periódico en un solo hilo
+ * @param listaGestion Lista de gestión sobre la que se opera
+ * @param rutasFuentes Fuentes de ingesta
+ * @param numFuentes Número de fuentes
+ * @param periodo Segundos entre procesamientos (0 = sin procesamiento periódico)
+ * @return false si el bucle de eventos no está disponible en esta plataforma
+ */
+bool ejecutarBucleEventos(ListaGestion& listaGestion, const char* const* rutasFuentes, int numFuentes,
+                          double periodo) {
+    BucleEventos bucle;
+    if (!bucle.estaDisponible()) {
+        return false;
+    }
+    if (!bucle.detenerConSenales()) {
+        std::cout << "Advertencia: no se pudieron atender SIGINT/SIGTERM; terminarán el proceso sin limpieza."
+                  << std::endl;
+    }
+    
+    int fuentes[MAX_FUENTES];
+    for (int i = 0; i < numFuentes; i++) {
+        fuentes[i] = abrirFuente(rutasFuentes[i]);
+        if (fuentes[i] < 0) {
+            std::cout << "Advertencia: no se pudo abrir la fuente '" << rutasFuentes[i] << "'." << std::endl;
+        } else {
+            atenderFuente(bucle, listaGestion, fuentes[i], rutasFuentes[i]);
+        }
+    }
+    if (periodo > 0.0) {
+        procesarPeriodicamente(bucle, listaGestion, periodo);
+    }
+    atenderConsola(bucle, listaGestion);
+    
+    bucle.ejecutar();
+    if (bucle.obtenerSenalRecibida() != 0) {
+        std::cout << std::endl << "[Log] Señal " << bucle.obtenerSenalRecibida() << " recibida: cerrando sistema..."
+                  << std::endl;
+    }
+    
+    for (int i = 0; i < numFuentes; i++) {
+        if (fuentes[i] >= 0) {
+            cerrarFuente(fuentes[i]);
+        }
+    }
+    return true;
 }
 
 /**
  * @brief Función principal del programa
+ * 
+ * Opciones de línea de comandos:
+ * - `--compresion N`: historiales comprimidos en bloques de N lecturas
+ * - `--indice [MIN:MAX]`: índice de valores en los historiales; los sensores
+ *   enteros cuentan los valores de MIN a MAX en un arreglo denso
+ * - `--regla "ESPECIFICACION"`: agrega una regla de alerta (repetible)
+ * - `--shm [/NOMBRE][:RANURAS]`: publica lecturas y estadísticas en memoria
+ *   compartida para `sensor_iot_consulta`; sin RANURAS el segmento se
+ *   dimensiona con la capacidad del registro tras cargar el manifiesto
+ * - `--script ARCHIVO`: ejecuta los comandos del archivo sin menú y al
+ *   terminar reporta rendimiento y latencia por tipo de comando
+ * - `--silencioso`: descarta la salida de consola salvo el reporte
+ * - `--manifiesto ARCHIVO`: da de alta los sensores listados en el archivo
+ *   (una línea `tipo nombre [compresion=N] [reserva=N]` por sensor)
+ * - `--eventos`: atiende la consola desde un bucle de eventos de un solo hilo,
+ *   con un comando completo por línea, sin detener la ingesta de las fuentes;
+ *   el bucle termina con la opción 8, con SIGINT/SIGTERM o cuando no queda
+ *   nada que atender
+ * - `--fuente RUTA`: ingiere líneas `TEMP:NOMBRE:VALOR` o `PRES:NOMBRE:VALOR`
+ *   desde una FIFO, dispositivo serie o archivo (repetible; implica `--eventos`)
+ * - `--procesar-cada N`: procesa cada N segundos los sensores con lecturas
+ *   nuevas (implica `--eventos`)
+ * - `--memoria-numa`: los nodos de los historiales se reservan en arenas por
+ *   nodo NUMA, en el nodo del hilo que ingiere cada sensor
+ * - `--paginas-grandes`: como `--memoria-numa`, con regiones de páginas de 2 MB
+ * 
+ * Cada línea de un script contiene lo que se teclearía en el menú para un
+ * comando: la opción seguida de sus datos. Las líneas que empiezan con `#`
+ * son comentarios y el fin del archivo equivale a la opción 8. Por ejemplo:
+ * @code
+ * # Alta, lecturas y procesamiento
+ * 1 T-001
+ * 3 T-001 45.3
+ * 10 T-001 3 42.1 44.0 46.2
+ * 4
+ * 7 T-001
+ * @endcode
+ * 
+ * @param argc Número de argumentos
+ * @param argv Argumentos de línea de comandos
  * @return Código de estado de salida
  */
-int main() {
+int main(int argc, char* argv[]) {
     ListaGestion listaGestion;
-    int opcion;
+    int opcion = 0;
+    const char* rutaScript = nullptr;
+    const char* rutaManifiesto = nullptr;
+    const char* rutasFuentes[MAX_FUENTES];
+    int numFuentes = 0;
+    double periodo = 0.0;
+    bool eventos = false;
+    bool silencioso = false;
+    bool publicar = false;
+    char segmento[TAM_NOMBRE_SENSOR];
+    int ranurasSegmento = 0;
+    std::strcpy(segmento, NOMBRE_SEGMENTO_SENSORES);
+    
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--compresion") == 0 && i + 1 < argc) {
+            listaGestion.establecerCompresion(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--indice") == 0) {
+            long long minimo = 0;
+            long long maximo = -1;
+            if (i + 1 < argc && std::strchr(argv[i + 1], ':') != nullptr) {
+                char* separador = nullptr;
+                minimo = std::strtoll(argv[++i], &separador, 10);
+                maximo = std::strtoll(separador + 1, nullptr, 10);
+            }
+            listaGestion.establecerIndice(minimo, maximo);
+        } else if (std::strcmp(argv[i], "--shm") == 0) {
+            publicar = true;
+            if (i + 1 < argc && argv[i + 1][0] == '/') {
+                const char* valor = argv[++i];
+                const char* separador = std::strchr(valor, ':');
+                std::size_t largo = separador != nullptr ? static_cast<std::size_t>(separador - valor)
+                                                         : std::strlen(valor);
+                if (largo >= sizeof(segmento)) {
+                    largo = sizeof(segmento) - 1;
+                }
+                std::memcpy(segmento, valor, largo);
+                segmento[largo] = '\0';
+                if (separador != nullptr) {
+                    ranurasSegmento = std::atoi(separador + 1);
+                    if (ranurasSegmento <= 0) {
+                        std::cout << "Advertencia: número de ranuras inválido en '" << valor
+                                  << "'; se usa la capacidad del registro." << std::endl;
+                        ranurasSegmento = 0;
+                    }
+                }
+            }
+        } else if (std::strcmp(argv[i], "--regla") == 0 && i + 1 < argc) {
+            if (listaGestion.agregarRegla(argv[++i]) < 0) {
+                std::cout << "Advertencia: regla inválida '" << argv[i] << "'." << std::endl;
+            }
+        } else if (std::strcmp(argv[i], "--manifiesto") == 0 && i + 1 < argc) {
+            rutaManifiesto = argv[++i];
+        } else if (std::strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+            rutaScript = argv[++i];
+        } else if (std::strcmp(argv[i], "--silencioso") == 0) {
+            silencioso = true;
+        } else if (std::strcmp(argv[i], "--eventos") == 0) {
+            eventos = true;
+        } else if (std::strcmp(argv[i], "--fuente") == 0 && i + 1 < argc) {
+            if (numFuentes < MAX_FUENTES) {
+                rutasFuentes[numFuentes++] = argv[++i];
+            } else {
+                std::cout << "Advertencia: se ignora la fuente '" << argv[++i] << "' (máximo "
+                          << MAX_FUENTES << ")." << std::endl;
+            }
+            eventos = true;
+        } else if (std::strcmp(argv[i], "--procesar-cada") == 0 && i + 1 < argc) {
+            periodo = std::atof(argv[++i]);
+            eventos = true;
+        } else if (std::strcmp(argv[i], "--memoria-numa") == 0) {
+            MemoriaHistorial::global().habilitar(false);
+        } else if (std::strcmp(argv[i], "--paginas-grandes") == 0) {
+            MemoriaHistorial::global().habilitar(true);
+        } else {
+            std::cout << "Advertencia: argumento desconocido '" << argv[i] << "'." << std::endl;
+        }
+    }
+    
+    std::ifstream archivoScript;
+    if (rutaScript != nullptr) {
+        archivoScript.open(rutaScript);
+        if (!archivoScript) {
+            std::cout << "Error: No se pudo abrir el script '" << rutaScript << "'." << std::endl;
+            return 1;
+        }
+    }
+    
+    // Sin búfer de destino, cada escritura a std::cout se descarta de inmediato
+    std::streambuf* consola = std::cout.rdbuf();
+    if (silencioso) {
+        std::cout.rdbuf(nullptr);
+    }
     
     std::cout << "=== Iniciando Sistema IoT de Monitoreo Polimórfico ===" << std::endl;
     
+    // Se carga tras leer todas las opciones para que compresión, índice y memoria ya apliquen
+    if (rutaManifiesto != nullptr && listaGestion.cargarManifiesto(rutaManifiesto) < 0) {
+        std::cout.rdbuf(consola);
+        std::cout << "Error: No se pudo leer el manifiesto '" << rutaManifiesto << "'." << std::endl;
+        return 1;
+    }
+    
+    // Tras el manifiesto, para que el segmento tenga ranura para cada sensor ya dado de alta
+    if (publicar && !listaGestion.habilitarPublicacion(segmento, ranurasSegmento)) {
+        std::cout.rdbuf(consola);
+        std::cout << "Advertencia: no se pudo publicar el segmento '" << segmento << "'." << std::endl;
+        if (silencioso) {
+            std::cout.rdbuf(nullptr);
+        }
+    }
+    
+    if (rutaScript != nullptr) {
+        PerfilComandos perfil;
+        perfil.iniciar();
+        ejecutarScript(archivoScript, listaGestion, perfil);
+        perfil.terminar();
+        
+        std::cout.rdbuf(consola);
+        std::cout.clear();
+        perfil.imprimirReporte(std::cout, OPCIONES_MENU, NUM_OPCIONES_MENU);
+        if (MemoriaHistorial::global().estaHabilitado()) {
+            MemoriaHistorial::global().imprimirEstadisticas(std::cout);
+        }
+        if (silencioso) {
+            std::cout.rdbuf(nullptr);
+        }
+        return 0;
+    }
+    
+    if (eventos) {
+        if (ejecutarBucleEventos(listaGestion, rutasFuentes, numFuentes, periodo)) {
+            return 0;
+        }
+        std::cout << "Advertencia: el bucle de eventos requiere Linux (epoll); se usa el menú interactivo."
+                  << std::endl;
+    }
+    
     do {
         mostrarMenu();
         std::cin >> opcion;
         
         if (std::cin.fail()) {
+            if (std::cin.eof()) {
+                break;  // Fin de la entrada: equivale a cerrar el sistema
+            }
             std::cout << "Error: Ingrese un número válido." << std::endl;
-            limpiarBuffer();
+            limpiarBuffer(std::cin);
             continue;
         }
         
-        switch (opcion) {
-            case 1: {
-                std::cout << "\nOpción 1: Crear Sensor (Tipo Temp - FLOAT)" << std::endl;
-                char nombre[50];
-                std::cout << "Ingrese el nombre del sensor de temperatura: ";
-                std::cin >> nombre;
-                
-                SensorTemperatura* sensorTemp = new SensorTemperatura(nombre);
-                listaGestion.insertarSensor(sensorTemp);
-                break;
-            }
-            
-            case 2: {
-                std::cout << "\nOpción 2: Crear Sensor (Tipo Presión - INT)" << std::endl;
-                char nombre[50];
-                std::cout << "Ingrese el nombre del sensor de presión: ";
-                std::cin >> nombre;
-                
-                SensorPresion* sensorPresion = new SensorPresion(nombre);
-                listaGestion.insertarSensor(sensorPresion);
-                break;
-            }
-            
-            case 3: {
-                std::cout << "\nOpción 3: Registrar Lectura" << std::endl;
-                char nombre[50];
-                std::cout << "Ingrese el nombre del sensor: ";
-                std::cin >> nombre;
-                
-                SensorBase* sensor = listaGestion.buscarSensor(nombre);
-                if (sensor == nullptr) {
-                    std::cout << "Error: Sensor '" << nombre << "' no encontrado." << std::endl;
-                    break;
-                }
-                
-                // Downcasting seguro para determinar el tipo de sensor
-                SensorTemperatura* sensorTemp = dynamic_cast<SensorTemperatura*>(sensor);
-                SensorPresion* sensorPresion = dynamic_cast<SensorPresion*>(sensor);
-                
-                if (sensorTemp != nullptr) {
-                    float temperatura;
-                    std::cout << "Ingrese la lectura de temperatura (float): ";
-                    std::cin >> temperatura;
-                    
-                    if (std::cin.fail()) {
-                        std::cout << "Error: Valor inválido para temperatura." << std::endl;
-                        limpiarBuffer();
-                        break;
-                    }
-                    
-                    sensorTemp->registrarLectura(temperatura);
-                    std::cout << "ID: " << nombre << ". Valor: " << temperatura << " (float)" << std::endl;
-                    
-                } else if (sensorPresion != nullptr) {
-                    int presion;
-                    std::cout << "Ingrese la lectura de presión (int): ";
-                    std::cin >> presion;
-                    
-                    if (std::cin.fail()) {
-                        std::cout << "Error: Valor inválido para presión." << std::endl;
-                        limpiarBuffer();
-                        break;
-                    }
-                    
-                    sensorPresion->registrarLectura(presion);
-                    std::cout << "ID: " << nombre << ". Valor: " << presion << " (int)" << std::endl;
-                }
-                break;
-            }
-            
-            case 4: {
-                std::cout << "\nOpción 4: Ejecutar Procesamiento Polimórfico" << std::endl;
-                listaGestion.ejecutarProcesamientoPolimorfico();
-                break;
-            }
-            
-            case 5: {
-                std::cout << "\nOpción 5: Mostrar Información de Sensor" << std::endl;
-                char nombre[50];
-                std::cout << "Ingrese el nombre del sensor: ";
-                std::cin >> nombre;
-                
-                SensorBase* sensor = listaGestion.buscarSensor(nombre);
-                if (sensor != nullptr) {
-                    sensor->imprimirInfo();
-                } else {
-                    std::cout << "Error: Sensor '" << nombre << "' no encontrado." << std::endl;
-                }
-                break;
-            }
-            
-            case 6: {
-                std::cout << "\nOpción 6: Listar Todos los Sensores" << std::endl;
-                listaGestion.mostrarTodosSensores();
-                break;
-            }
-            
-            case 7: {
-                std::cout << "\nOpción 7: Mostrar Historial de Sensor" << std::endl;
-                char nombre[50];
-                std::cout << "Ingrese el nombre del sensor: ";
-                std::cin >> nombre;
-                
-                SensorBase* sensor = listaGestion.buscarSensor(nombre);
-                if (sensor == nullptr) {
-                    std::cout << "Error: Sensor '" << nombre << "' no encontrado." << std::endl;
-                    break;
-                }
-                
-                SensorTemperatura* sensorTemp = dynamic_cast<SensorTemperatura*>(sensor);
-                SensorPresion* sensorPresion = dynamic_cast<SensorPresion*>(sensor);
-                
-                if (sensorTemp != nullptr) {
-                    sensorTemp->mostrarHistorial();
-                } else if (sensorPresion != nullptr) {
-                    sensorPresion->mostrarHistorial();
-                }
-                break;
-            }
-            
-            case 8: {
-                std::cout << "\nOpción 8: Cerrar Sistema (Liberar Memoria)" << std::endl;
-                std::cout << "Cerrando sistema..." << std::endl;
-                break;
-            }
-            
-            default: {
-                std::cout << "Error: Opción inválida. Seleccione una opción del 1 al 8." << std::endl;
-                break;
-            }
-        }
+        ejecutarComando(opcion, listaGestion, std::cin);
+        
+        listaGestion.atenderAlertas();
         
     } while (opcion != 8);
     
     return 0;
-}
\ No newline at end of file
+}